@@ -1,161 +1,3262 @@
 #include <iostream>
 #include <cmath>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cfloat>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Optional hot-path instrumentation, compiled in with -DBOND_INSTRUMENT. When
+// it is off, the BOND_* hooks expand to nothing and cost nothing.
+#ifdef BOND_INSTRUMENT
+// Log-linear histogram of nanosecond latencies: 8 linear sub-buckets per power
+// of two, so every bucket is within 12.5% of its value.
+class LatencyHistogram {
+public:
+    static constexpr int sub_buckets = 8;
+    static constexpr int bucket_count = 64 * sub_buckets;
+
+    void record(std::uint64_t ns) {
+        buckets[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static int bucket_of(std::uint64_t ns) {
+        if (ns < sub_buckets) {
+            return static_cast<int>(ns);
+        }
+        int exponent = 63 - __builtin_clzll(ns); // >= 3
+        int sub = static_cast<int>(ns >> (exponent - 3)) - sub_buckets;
+        return (exponent - 2) * sub_buckets + sub;
+    }
+
+    static std::uint64_t lower_bound(int bucket) {
+        if (bucket < sub_buckets) {
+            return bucket;
+        }
+        int exponent = bucket / sub_buckets + 2;
+        return static_cast<std::uint64_t>(sub_buckets + bucket % sub_buckets) << (exponent - 3);
+    }
+
+    void dump(std::FILE* out, const char* name) const {
+        for (int b = 0; b < bucket_count; ++b) {
+            std::uint64_t n = buckets[b].load(std::memory_order_relaxed);
+            if (n) {
+                std::fprintf(out, "%s_ns{ge=\"%llu\"} %llu\n", name, static_cast<unsigned long long>(lower_bound(b)),
+                             static_cast<unsigned long long>(n));
+            }
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> buckets[bucket_count] = {};
+};
+
+struct Instrumentation {
+    std::atomic<std::uint64_t> pow_calls{0};
+    std::atomic<std::uint64_t> ytm_calls{0};
+    std::atomic<std::uint64_t> break_even_calls{0};
+    std::atomic<std::uint64_t> solver_iterations{0};
+    std::atomic<std::uint64_t> non_converged{0};
+    std::atomic<std::uint64_t> iterations_per_solve[65] = {}; // Last slot collects 64+
+    LatencyHistogram ytm_latency;
+    LatencyHistogram break_even_latency;
+
+    void record_solve(int iterations, bool converged) {
+        solver_iterations.fetch_add(iterations, std::memory_order_relaxed);
+        iterations_per_solve[iterations < 64 ? iterations : 64].fetch_add(1, std::memory_order_relaxed);
+        if (!converged) {
+            non_converged.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Writes every counter as "name value" lines; safe while other threads run.
+    bool dump(const char* path) const {
+        std::FILE* out = std::fopen(path, "w");
+        if (!out) {
+            return false;
+        }
+        auto counter = [&](const char* name, const std::atomic<std::uint64_t>& value) {
+            std::fprintf(out, "%s %llu\n", name, static_cast<unsigned long long>(value.load(std::memory_order_relaxed)));
+        };
+        counter("pow_calls", pow_calls);
+        counter("ytm_calls", ytm_calls);
+        counter("break_even_calls", break_even_calls);
+        counter("solver_iterations", solver_iterations);
+        counter("non_converged", non_converged);
+        for (int i = 0; i <= 64; ++i) {
+            std::uint64_t n = iterations_per_solve[i].load(std::memory_order_relaxed);
+            if (n) {
+                std::fprintf(out, "iterations_per_solve{n=\"%d%s\"} %llu\n", i, i == 64 ? "+" : "", static_cast<unsigned long long>(n));
+            }
+        }
+        ytm_latency.dump(out, "ytm_latency");
+        break_even_latency.dump(out, "break_even_latency");
+        return std::fclose(out) == 0;
+    }
+};
+
+inline Instrumentation& instrumentation() {
+    static Instrumentation instance;
+    return instance;
+}
+
+// Records the lifetime of the enclosing scope into a histogram.
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define BOND_COUNT(counter, n) instrumentation().counter.fetch_add((n), std::memory_order_relaxed)
+#define BOND_RECORD_SOLVE(iterations, converged) instrumentation().record_solve((iterations), (converged))
+#define BOND_TIME_SCOPE(histogram) ScopedLatency bond_scoped_latency(instrumentation().histogram)
+#else
+#define BOND_COUNT(counter, n) ((void)0)
+#define BOND_RECORD_SOLVE(iterations, converged) ((void)0)
+#define BOND_TIME_SCOPE(histogram) ((void)0)
+#endif
+
+inline bool dump_instrumentation(const char* path) {
+#ifdef BOND_INSTRUMENT
+    return instrumentation().dump(path);
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Every discount-factor pow goes through here so it can be counted.
+inline double discount_pow(double base, double exponent) {
+    BOND_COUNT(pow_calls, 1);
+    return pow(base, exponent);
+}
+
+// Period loops step discount factors by repeated multiplication and re-anchor
+// them with pow at the start of every block of this many periods, which keeps
+// them within a few ulps of pow.
+constexpr int simd_anchor_periods = 64;
+
+enum class Sensitivity { Yield, CouponRate, FaceValue };
+
+enum class PricingMode {
+    ClosedForm, // Annuity plus principal, same cost for any number of periods
+    Vectorized, // SIMD cash-flow kernel picked for this CPU
+    Reference   // Per-period discounting loop
+};
+
+enum class DiscountMethod {
+    Pow,        // pow per period
+    Recurrence, // Repeated multiplication, re-anchored every simd_anchor_periods
+    LogExp      // exp(-t log1p(r)): no loop-carried dependency, for long schedules
+};
+
+// Fills df[t] = (1 + periodic_rate)^-t for t = 0..periods. Recurrence stays
+// within a few ulps of Pow; LogExp's error grows with t log(1 + r), to about
+// 1e-13 relative over 100 years of monthly periods.
+inline void fill_discount_factors(double periodic_rate, int periods, double* df, DiscountMethod method) {
+    double growth = 1 + periodic_rate;
+    df[0] = 1.0;
+    if (method == DiscountMethod::Recurrence) {
+        double discount = 1 / growth;
+        for (int anchor = 1; anchor <= periods; anchor += simd_anchor_periods) {
+            int end = std::min(anchor + simd_anchor_periods, periods + 1);
+            df[anchor] = 1 / discount_pow(growth, anchor);
+            for (int t = anchor + 1; t < end; ++t) {
+                df[t] = df[t - 1] * discount;
+            }
+        }
+    } else if (method == DiscountMethod::LogExp) {
+        double log_growth = log1p(periodic_rate);
+        for (int t = 1; t <= periods; ++t) {
+            df[t] = exp(-t * log_growth);
+        }
+    } else {
+        for (int t = 1; t <= periods; ++t) {
+            df[t] = 1 / discount_pow(growth, t);
+        }
+    }
+}
+
+// Durations and convexity are measured in periods, like the Bond methods.
+struct BondAnalytics {
+    double price;
+    double macaulay_duration;
+    double modified_duration;
+    double convexity;
+    double dv01; // Price gain for a one basis point drop in yield
+};
+
+struct YieldSolution {
+    double yield;
+    int iterations;
+    bool converged;
+    double duration; // Modified duration in years at the last yield evaluated, for warm starts
+};
+
+// Discounted cash-flow sums for one bond, with v the per-period discount
+// factor and CF_t the cash flow at period t:
+//   pv = sum CF_t v^t, weighted = sum t CF_t v^t, curvature = sum t (t + 1) CF_t v^t
+struct CashFlowSums {
+    double pv;
+    double weighted;
+    double curvature;
+};
+
+inline BondAnalytics analytics_from_sums(const CashFlowSums& sums, double discount, int payment_frequency) {
+    BondAnalytics result;
+    result.price = sums.pv;
+    result.macaulay_duration = sums.weighted / sums.pv;
+    result.modified_duration = result.macaulay_duration * discount;
+    result.convexity = sums.curvature * discount * discount / sums.pv;
+    result.dv01 = sums.pv * result.modified_duration / payment_frequency * 1e-4;
+    return result;
+}
+
+// Adds the principal repayment to per-unit-coupon sums.
+inline CashFlowSums add_principal(double sum0, double sum1, double sum2, double coupon, double face_value, double discount, int periods) {
+    double principal = face_value * discount_pow(discount, periods);
+    return {coupon * sum0 + principal, coupon * sum1 + periods * principal, coupon * sum2 + periods * (periods + 1.0) * principal};
+}
+
+inline CashFlowSums cash_flow_sums_scalar(double coupon, double face_value, double discount, int periods) {
+    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, df = 1.0;
+    for (int t = 1; t <= periods; ++t) {
+        df = (t - 1) % simd_anchor_periods == 0 ? discount_pow(discount, t) : df * discount;
+        sum0 += df;
+        sum1 += t * df;
+        sum2 += t * (t + 1.0) * df;
+    }
+    return add_principal(sum0, sum1, sum2, coupon, face_value, discount, periods);
+}
+
+inline void cash_flow_sums_lanes_scalar(const double* coupon, const double* face_value, const double* discount, const int* periods,
+                                        std::size_t count, double* pv, double* weighted, double* curvature) {
+    for (std::size_t i = 0; i < count; ++i) {
+        CashFlowSums sums = cash_flow_sums_scalar(coupon[i], face_value[i], discount[i], periods[i]);
+        pv[i] = sums.pv;
+        weighted[i] = sums.weighted;
+        curvature[i] = sums.curvature;
+    }
+}
+
+// Adds periods t..periods, fewer than one vector's worth, left over after a
+// kernel's main loop; one pow, then repeated multiplication.
+inline void add_tail_periods(double& s0, double& s1, double& s2, double discount, int t, int periods) {
+    if (t > periods) {
+        return;
+    }
+    for (double df = discount_pow(discount, t); t <= periods; ++t, df *= discount) {
+        s0 += df;
+        s1 += t * df;
+        s2 += t * (t + 1.0) * df;
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOND_SIMD_X86 1
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+inline CashFlowSums cash_flow_sums_sse2(double coupon, double face_value, double discount, int periods) {
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd(), sum2 = _mm_setzero_pd();
+    __m128d powers = _mm_set_pd(discount * discount, discount);
+    __m128d step = _mm_set1_pd(discount * discount);
+    __m128d one = _mm_set1_pd(1.0), two = _mm_set1_pd(2.0);
+    int t = 1;
+    while (t + 1 <= periods) {
+        __m128d df = _mm_mul_pd(_mm_set1_pd(discount_pow(discount, t - 1)), powers);
+        __m128d tv = _mm_set_pd(t + 1, t);
+        for (int k = 0; k < simd_anchor_periods / 2 && t + 1 <= periods; ++k, t += 2) {
+            __m128d tdf = _mm_mul_pd(tv, df);
+            sum0 = _mm_add_pd(sum0, df);
+            sum1 = _mm_add_pd(sum1, tdf);
+            sum2 = _mm_add_pd(sum2, _mm_mul_pd(_mm_add_pd(tv, one), tdf));
+            df = _mm_mul_pd(df, step);
+            tv = _mm_add_pd(tv, two);
+        }
+    }
+    double lanes0[2], lanes1[2], lanes2[2];
+    _mm_storeu_pd(lanes0, sum0);
+    _mm_storeu_pd(lanes1, sum1);
+    _mm_storeu_pd(lanes2, sum2);
+    double s0 = lanes0[0] + lanes0[1], s1 = lanes1[0] + lanes1[1], s2 = lanes2[0] + lanes2[1];
+    add_tail_periods(s0, s1, s2, discount, t, periods);
+    return add_principal(s0, s1, s2, coupon, face_value, discount, periods);
+}
+
+__attribute__((target("sse2")))
+inline void cash_flow_sums_lanes_sse2(const double* coupon, const double* face_value, const double* discount, const int* periods,
+                                      std::size_t count, double* pv, double* weighted, double* curvature) {
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(discount + i);
+        __m128d n = _mm_set_pd(periods[i + 1], periods[i]);
+        int max_periods = periods[i] > periods[i + 1] ? periods[i] : periods[i + 1];
+        __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd(), sum2 = _mm_setzero_pd();
+        __m128d one = _mm_set1_pd(1.0);
+        __m128d principal = one, df = one;
+        for (int t = 1; t <= max_periods; ++t) {
+            if ((t - 1) % simd_anchor_periods == 0) {
+                df = _mm_set_pd(discount_pow(discount[i + 1], t), discount_pow(discount[i], t));
+            } else {
+                df = _mm_mul_pd(df, v);
+            }
+            __m128d tv = _mm_set1_pd(t);
+            __m128d live = _mm_and_pd(df, _mm_cmple_pd(tv, n));
+            __m128d last = _mm_cmpeq_pd(tv, n);
+            __m128d tdf = _mm_mul_pd(tv, live);
+            sum0 = _mm_add_pd(sum0, live);
+            sum1 = _mm_add_pd(sum1, tdf);
+            sum2 = _mm_add_pd(sum2, _mm_mul_pd(_mm_add_pd(tv, one), tdf));
+            principal = _mm_or_pd(_mm_and_pd(last, df), _mm_andnot_pd(last, principal));
+        }
+        __m128d c = _mm_loadu_pd(coupon + i);
+        __m128d fp = _mm_mul_pd(_mm_loadu_pd(face_value + i), principal);
+        __m128d nfp = _mm_mul_pd(n, fp);
+        _mm_storeu_pd(pv + i, _mm_add_pd(_mm_mul_pd(c, sum0), fp));
+        _mm_storeu_pd(weighted + i, _mm_add_pd(_mm_mul_pd(c, sum1), nfp));
+        _mm_storeu_pd(curvature + i, _mm_add_pd(_mm_mul_pd(c, sum2), _mm_mul_pd(_mm_add_pd(n, one), nfp)));
+    }
+    cash_flow_sums_lanes_scalar(coupon + i, face_value + i, discount + i, periods + i, count - i, pv + i, weighted + i, curvature + i);
+}
+
+__attribute__((target("avx2,fma")))
+inline double horizontal_sum_avx2(__m256d x) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2,fma")))
+inline CashFlowSums cash_flow_sums_avx2(double coupon, double face_value, double discount, int periods) {
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd(), sum2 = _mm256_setzero_pd();
+    double d2 = discount * discount;
+    __m256d powers = _mm256_set_pd(d2 * d2, d2 * discount, d2, discount);
+    __m256d step = _mm256_set1_pd(d2 * d2);
+    __m256d one = _mm256_set1_pd(1.0), four = _mm256_set1_pd(4.0);
+    int t = 1;
+    while (t + 3 <= periods) {
+        __m256d df = _mm256_mul_pd(_mm256_set1_pd(discount_pow(discount, t - 1)), powers);
+        __m256d tv = _mm256_set_pd(t + 3, t + 2, t + 1, t);
+        for (int k = 0; k < simd_anchor_periods / 4 && t + 3 <= periods; ++k, t += 4) {
+            __m256d tdf = _mm256_mul_pd(tv, df);
+            sum0 = _mm256_add_pd(sum0, df);
+            sum1 = _mm256_add_pd(sum1, tdf);
+            sum2 = _mm256_fmadd_pd(_mm256_add_pd(tv, one), tdf, sum2);
+            df = _mm256_mul_pd(df, step);
+            tv = _mm256_add_pd(tv, four);
+        }
+    }
+    double s0 = horizontal_sum_avx2(sum0), s1 = horizontal_sum_avx2(sum1), s2 = horizontal_sum_avx2(sum2);
+    add_tail_periods(s0, s1, s2, discount, t, periods);
+    return add_principal(s0, s1, s2, coupon, face_value, discount, periods);
+}
+
+__attribute__((target("avx2,fma")))
+inline void cash_flow_sums_lanes_avx2(const double* coupon, const double* face_value, const double* discount, const int* periods,
+                                      std::size_t count, double* pv, double* weighted, double* curvature) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(discount + i);
+        __m256d n = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(periods + i)));
+        int max_periods = 0;
+        for (int k = 0; k < 4; ++k) {
+            max_periods = periods[i + k] > max_periods ? periods[i + k] : max_periods;
+        }
+        __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd(), sum2 = _mm256_setzero_pd();
+        __m256d one = _mm256_set1_pd(1.0);
+        __m256d principal = one, df = one;
+        for (int t = 1; t <= max_periods; ++t) {
+            if ((t - 1) % simd_anchor_periods == 0) {
+                df = _mm256_set_pd(discount_pow(discount[i + 3], t), discount_pow(discount[i + 2], t), discount_pow(discount[i + 1], t), discount_pow(discount[i], t));
+            } else {
+                df = _mm256_mul_pd(df, v);
+            }
+            __m256d tv = _mm256_set1_pd(t);
+            __m256d live = _mm256_and_pd(df, _mm256_cmp_pd(tv, n, _CMP_LE_OQ));
+            __m256d tdf = _mm256_mul_pd(tv, live);
+            sum0 = _mm256_add_pd(sum0, live);
+            sum1 = _mm256_add_pd(sum1, tdf);
+            sum2 = _mm256_fmadd_pd(_mm256_add_pd(tv, one), tdf, sum2);
+            principal = _mm256_blendv_pd(principal, df, _mm256_cmp_pd(tv, n, _CMP_EQ_OQ));
+        }
+        __m256d c = _mm256_loadu_pd(coupon + i);
+        __m256d fp = _mm256_mul_pd(_mm256_loadu_pd(face_value + i), principal);
+        __m256d nfp = _mm256_mul_pd(n, fp);
+        _mm256_storeu_pd(pv + i, _mm256_fmadd_pd(c, sum0, fp));
+        _mm256_storeu_pd(weighted + i, _mm256_fmadd_pd(c, sum1, nfp));
+        _mm256_storeu_pd(curvature + i, _mm256_fmadd_pd(c, sum2, _mm256_mul_pd(_mm256_add_pd(n, one), nfp)));
+    }
+    cash_flow_sums_lanes_scalar(coupon + i, face_value + i, discount + i, periods + i, count - i, pv + i, weighted + i, curvature + i);
+}
+
+__attribute__((target("avx512f")))
+inline CashFlowSums cash_flow_sums_avx512(double coupon, double face_value, double discount, int periods) {
+    __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd(), sum2 = _mm512_setzero_pd();
+    double lane_powers[8];
+    lane_powers[0] = discount;
+    for (int k = 1; k < 8; ++k) {
+        lane_powers[k] = lane_powers[k - 1] * discount;
+    }
+    __m512d powers = _mm512_loadu_pd(lane_powers);
+    __m512d step = _mm512_set1_pd(lane_powers[7]);
+    __m512d one = _mm512_set1_pd(1.0), eight = _mm512_set1_pd(8.0);
+    __m512d lane_index = _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0);
+    int t = 1;
+    while (t + 7 <= periods) {
+        __m512d df = _mm512_mul_pd(_mm512_set1_pd(discount_pow(discount, t - 1)), powers);
+        __m512d tv = _mm512_add_pd(_mm512_set1_pd(t), lane_index);
+        for (int k = 0; k < simd_anchor_periods / 8 && t + 7 <= periods; ++k, t += 8) {
+            __m512d tdf = _mm512_mul_pd(tv, df);
+            sum0 = _mm512_add_pd(sum0, df);
+            sum1 = _mm512_add_pd(sum1, tdf);
+            sum2 = _mm512_fmadd_pd(_mm512_add_pd(tv, one), tdf, sum2);
+            df = _mm512_mul_pd(df, step);
+            tv = _mm512_add_pd(tv, eight);
+        }
+    }
+    double lanes0[8], lanes1[8], lanes2[8];
+    _mm512_storeu_pd(lanes0, sum0);
+    _mm512_storeu_pd(lanes1, sum1);
+    _mm512_storeu_pd(lanes2, sum2);
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+    for (int k = 0; k < 8; ++k) {
+        s0 += lanes0[k];
+        s1 += lanes1[k];
+        s2 += lanes2[k];
+    }
+    add_tail_periods(s0, s1, s2, discount, t, periods);
+    return add_principal(s0, s1, s2, coupon, face_value, discount, periods);
+}
+
+__attribute__((target("avx512f")))
+inline void cash_flow_sums_lanes_avx512(const double* coupon, const double* face_value, const double* discount, const int* periods,
+                                        std::size_t count, double* pv, double* weighted, double* curvature) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d v = _mm512_loadu_pd(discount + i);
+        double lane_periods[8];
+        int max_periods = 0;
+        for (int k = 0; k < 8; ++k) {
+            lane_periods[k] = periods[i + k];
+            max_periods = periods[i + k] > max_periods ? periods[i + k] : max_periods;
+        }
+        __m512d n = _mm512_loadu_pd(lane_periods);
+        __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd(), sum2 = _mm512_setzero_pd();
+        __m512d one = _mm512_set1_pd(1.0);
+        __m512d principal = one, df = one;
+        double anchor[8];
+        for (int t = 1; t <= max_periods; ++t) {
+            if ((t - 1) % simd_anchor_periods == 0) {
+                for (int k = 0; k < 8; ++k) {
+                    anchor[k] = discount_pow(discount[i + k], t);
+                }
+                df = _mm512_loadu_pd(anchor);
+            } else {
+                df = _mm512_mul_pd(df, v);
+            }
+            __m512d tv = _mm512_set1_pd(t);
+            __mmask8 live = _mm512_cmp_pd_mask(tv, n, _CMP_LE_OQ);
+            __m512d tdf = _mm512_maskz_mul_pd(live, tv, df);
+            sum0 = _mm512_mask_add_pd(sum0, live, sum0, df);
+            sum1 = _mm512_add_pd(sum1, tdf);
+            sum2 = _mm512_fmadd_pd(_mm512_add_pd(tv, one), tdf, sum2);
+            principal = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(tv, n, _CMP_EQ_OQ), principal, df);
+        }
+        __m512d c = _mm512_loadu_pd(coupon + i);
+        __m512d fp = _mm512_mul_pd(_mm512_loadu_pd(face_value + i), principal);
+        __m512d nfp = _mm512_mul_pd(n, fp);
+        _mm512_storeu_pd(pv + i, _mm512_fmadd_pd(c, sum0, fp));
+        _mm512_storeu_pd(weighted + i, _mm512_fmadd_pd(c, sum1, nfp));
+        _mm512_storeu_pd(curvature + i, _mm512_fmadd_pd(c, sum2, _mm512_mul_pd(_mm512_add_pd(n, one), nfp)));
+    }
+    cash_flow_sums_lanes_avx2(coupon + i, face_value + i, discount + i, periods + i, count - i, pv + i, weighted + i, curvature + i);
+}
+#endif
+
+enum class SimdIsa { Scalar, SSE2, AVX2, AVX512 };
+
+inline const char* simd_isa_name(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::SSE2: return "sse2";
+    case SimdIsa::AVX2: return "avx2";
+    case SimdIsa::AVX512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+// Per-ISA entry points: `single` walks the periods of one bond, `lanes`
+// runs one bond per vector lane over arrays of bonds.
+struct SimdKernels {
+    SimdIsa isa;
+    CashFlowSums (*single)(double coupon, double face_value, double discount, int periods);
+    void (*lanes)(const double* coupon, const double* face_value, const double* discount, const int* periods,
+                  std::size_t count, double* pv, double* weighted, double* curvature);
+};
+
+inline SimdIsa detect_simd_isa() {
+#ifdef BOND_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdIsa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdIsa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdIsa::SSE2;
+#endif
+    return SimdIsa::Scalar;
+}
+
+inline SimdKernels simd_kernels_for(SimdIsa isa) {
+    switch (isa) {
+#ifdef BOND_SIMD_X86
+    case SimdIsa::AVX512: return {isa, cash_flow_sums_avx512, cash_flow_sums_lanes_avx512};
+    case SimdIsa::AVX2: return {isa, cash_flow_sums_avx2, cash_flow_sums_lanes_avx2};
+    case SimdIsa::SSE2: return {isa, cash_flow_sums_sse2, cash_flow_sums_lanes_sse2};
+#endif
+    default: return {SimdIsa::Scalar, cash_flow_sums_scalar, cash_flow_sums_lanes_scalar};
+    }
+}
+
+// Chosen once from the CPU features. BOND_SIMD=scalar|sse2|avx2|avx512 can
+// force a lower tier, e.g. to compare kernels on the same host.
+inline const SimdKernels& simd_kernels() {
+    static const SimdKernels kernels = [] {
+        SimdIsa isa = detect_simd_isa();
+        if (const char* requested = std::getenv("BOND_SIMD")) {
+            for (SimdIsa candidate : {SimdIsa::Scalar, SimdIsa::SSE2, SimdIsa::AVX2, SimdIsa::AVX512}) {
+                if (std::strcmp(requested, simd_isa_name(candidate)) == 0 && candidate < isa) {
+                    isa = candidate;
+                }
+            }
+        }
+        return simd_kernels_for(isa);
+    }();
+    return kernels;
+}
+
+// Kernels with the payment frequency as a compile-time constant. The schedule
+// is walked a year at a time with one accumulator per period of the year, so
+// the inner loop has a fixed trip count the compiler unrolls and the periods
+// of a year carry no dependency on each other.
+template <int Freq>
+inline CashFlowSums cash_flow_sums_fixed(double coupon, double face_value, double discount, int years) {
+    constexpr int anchor_years = simd_anchor_periods / Freq > 0 ? simd_anchor_periods / Freq : 1;
+    double powers[Freq], df[Freq] = {}, sum0[Freq] = {}, sum1[Freq] = {}, sum2[Freq] = {};
+    powers[0] = discount;
+    for (int k = 1; k < Freq; ++k) {
+        powers[k] = powers[k - 1] * discount;
+    }
+    double step = powers[Freq - 1];
+
+    for (int y = 0; y < years; ++y) {
+        if (y % anchor_years == 0) {
+            double base = discount_pow(discount, y * Freq);
+            for (int k = 0; k < Freq; ++k) {
+                df[k] = base * powers[k];
+            }
+        }
+        for (int k = 0; k < Freq; ++k) {
+            double t = y * Freq + k + 1.0;
+            sum0[k] += df[k];
+            sum1[k] += t * df[k];
+            sum2[k] += t * (t + 1) * df[k];
+            df[k] *= step;
+        }
+    }
+
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+    for (int k = 0; k < Freq; ++k) {
+        s0 += sum0[k];
+        s1 += sum1[k];
+        s2 += sum2[k];
+    }
+    return add_principal(s0, s1, s2, coupon, face_value, discount, years * Freq);
+}
+
+// Whether the frequency-specialised kernel beats the tier's vector kernel.
+// Measured per tier: the vector kernels pay a fixed setup and reduction cost
+// per bond, so the specialised ones win for annual schedules up to about 30
+// years on every tier and, on AVX-512, also for semi-annual and quarterly
+// schedules of up to 16 periods; monthly schedules always go to the vector
+// kernels.
+inline bool prefer_fixed_kernel(SimdIsa isa, int years, int payment_frequency) {
+    if (isa == SimdIsa::Scalar) {
+        return true;
+    }
+    if (payment_frequency == 1) {
+        return years <= 32;
+    }
+    return isa == SimdIsa::AVX512 && (payment_frequency == 2 || payment_frequency == 4) && years * payment_frequency <= 16;
+}
+
+// Cash-flow sums for one bond, on the frequency-specialised kernel where it
+// is faster (see prefer_fixed_kernel) and on the tier's vector kernel
+// otherwise.
+inline CashFlowSums cash_flow_sums(double coupon, double face_value, double discount, int years, int payment_frequency) {
+    const SimdKernels& kernels = simd_kernels();
+    if (prefer_fixed_kernel(kernels.isa, years, payment_frequency)) {
+        switch (payment_frequency) {
+        case 1: return cash_flow_sums_fixed<1>(coupon, face_value, discount, years);
+        case 2: return cash_flow_sums_fixed<2>(coupon, face_value, discount, years);
+        case 4: return cash_flow_sums_fixed<4>(coupon, face_value, discount, years);
+        case 12: return cash_flow_sums_fixed<12>(coupon, face_value, discount, years);
+        default: break;
+        }
+    }
+    return kernels.single(coupon, face_value, discount, years * payment_frequency);
+}
+
+// Bounded cache of discount-factor vectors, shared by every bond priced at the
+// same (rate, frequency). A vector covers horizons 0..n, so shorter bonds reuse
+// the prefix of a longer one; a longer request rebuilds the entry. Lookups take
+// a shared lock and may run on any number of threads. Once full, the oldest
+// entry is evicted; vectors already handed out stay valid.
+class DiscountCache {
+public:
+    using Factors = std::shared_ptr<const std::vector<double>>;
+
+    explicit DiscountCache(std::size_t capacity = 4096, DiscountMethod method = DiscountMethod::Recurrence)
+        : capacity(capacity ? capacity : 1), method(method) {}
+
+    // Returns f with f[t] = (1 + rate / payment_frequency)^-t for t = 0..periods.
+    Factors factors(double rate, int payment_frequency, int periods) {
+        Key key{rate_bits(rate), payment_frequency};
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto found = entries.find(key);
+            if (found != entries.end() && static_cast<int>(found->second->size()) > periods) {
+                hit_count.fetch_add(1, std::memory_order_relaxed);
+                return found->second;
+            }
+        }
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+
+        auto built = std::make_shared<std::vector<double>>(periods + 1);
+        fill_discount_factors(rate / payment_frequency, periods, built->data(), method);
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto found = entries.find(key);
+        if (found != entries.end()) {
+            if (static_cast<int>(found->second->size()) > periods) {
+                return found->second; // Another thread got there first
+            }
+            found->second = built;
+            return built;
+        }
+        if (entries.size() >= capacity) {
+            entries.erase(insertion_order.front());
+            insertion_order.pop_front();
+        }
+        entries.emplace(key, built);
+        insertion_order.push_back(key);
+        return built;
+    }
+
+    std::uint64_t hits() const {
+        return hit_count.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t misses() const {
+        return miss_count.load(std::memory_order_relaxed);
+    }
+
+    std::size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return entries.size();
+    }
+
+private:
+    struct Key {
+        std::uint64_t rate;
+        int payment_frequency;
+
+        bool operator==(const Key& other) const {
+            return rate == other.rate && payment_frequency == other.payment_frequency;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return std::hash<std::uint64_t>()(key.rate * 31 + static_cast<std::uint64_t>(key.payment_frequency));
+        }
+    };
+
+    static std::uint64_t rate_bits(double rate) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &rate, sizeof bits);
+        return bits;
+    }
+
+    std::size_t capacity;
+    DiscountMethod method;
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Key, Factors, KeyHash> entries;
+    std::deque<Key> insertion_order;
+    std::atomic<std::uint64_t> hit_count{0};
+    std::atomic<std::uint64_t> miss_count{0};
+};
+
+// Second-order forward-mode dual number: a value carried together with its
+// first and second derivatives with respect to one seeded input.
+template <typename T>
+struct Dual2 {
+    T value;
+    T d1;
+    T d2;
+
+    Dual2(T value = T(), T d1 = T(), T d2 = T()) : value(value), d1(d1), d2(d2) {}
+
+    // The input being differentiated: d/dx x = 1.
+    static Dual2 variable(T value) {
+        return Dual2(value, T(1), T());
+    }
+};
+
+template <typename T>
+Dual2<T> operator+(const Dual2<T>& a, const Dual2<T>& b) {
+    return {a.value + b.value, a.d1 + b.d1, a.d2 + b.d2};
+}
+
+template <typename T>
+Dual2<T> operator-(const Dual2<T>& a, const Dual2<T>& b) {
+    return {a.value - b.value, a.d1 - b.d1, a.d2 - b.d2};
+}
+
+template <typename T>
+Dual2<T> operator*(const Dual2<T>& a, const Dual2<T>& b) {
+    return {a.value * b.value, a.d1 * b.value + a.value * b.d1, a.d2 * b.value + 2 * a.d1 * b.d1 + a.value * b.d2};
+}
+
+template <typename T>
+Dual2<T> operator/(const Dual2<T>& a, const Dual2<T>& b) {
+    // 1/b has derivatives -b'/b^2 and 2b'^2/b^3 - b''/b^2.
+    T inv = 1 / b.value;
+    Dual2<T> reciprocal(inv, -b.d1 * inv * inv, (2 * b.d1 * b.d1 * inv - b.d2) * inv * inv);
+    return a * reciprocal;
+}
+
+template <typename T>
+Dual2<T>& operator+=(Dual2<T>& a, const Dual2<T>& b) {
+    return a = a + b;
+}
+
+// x^n for integer n, by the chain rule on the exact power.
+template <typename T>
+Dual2<T> integer_pow(const Dual2<T>& x, int n) {
+    if (n == 0) {
+        return Dual2<T>(T(1));
+    }
+    T lower = discount_pow(x.value, n - 2); // x^(n-2)
+    T upper = lower * x.value;              // x^(n-1)
+    return {upper * x.value, n * upper * x.d1, n * (n - 1) * lower * x.d1 * x.d1 + n * upper * x.d2};
+}
+
+inline double integer_pow(double x, int n) {
+    return discount_pow(x, n);
+}
+
+// Reference pricing loop on any scalar type with +, *, / and integer_pow.
+// Discount factors step by repeated multiplication, re-anchored with
+// integer_pow every simd_anchor_periods periods like the vector kernels.
+template <typename Scalar>
+Scalar present_value_of(const Scalar& face_value, const Scalar& coupon_rate, int remaining_years, int payment_frequency,
+                        const Scalar& rate) {
+    Scalar freq(payment_frequency);
+    Scalar coupon = face_value * coupon_rate / freq;
+    Scalar discount = Scalar(1) / (Scalar(1) + rate / freq);
+    int periods = remaining_years * payment_frequency;
+    Scalar df(1), annuity(0);
+
+    for (int t = 1; t <= periods; ++t) {
+        df = (t - 1) % simd_anchor_periods == 0 ? integer_pow(discount, t) : df * discount;
+        annuity += df;
+    }
+    return coupon * annuity + face_value * df;
+}
+
+struct CashFlow {
+    int period;    // 1-based payment number
+    double time;   // Years from now
+    double amount; // Coupon, plus the principal on the last period
+};
+
+// Lazy range over a bond's remaining cash flows: each CashFlow is computed when
+// the iterator is dereferenced, so nothing is materialised or formatted.
+class CashFlowSchedule {
+public:
+    // Generates each flow on dereference, so it is an input iterator: `*it`
+    // is a temporary. It carries the schedule terms by value and stays valid
+    // after the schedule it came from is gone.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = CashFlow;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = CashFlow;
+
+        iterator(const CashFlowSchedule& schedule, int period)
+            : coupon(schedule.coupon), face_value(schedule.face_value), periods(schedule.periods),
+              payment_frequency(schedule.payment_frequency), period(period) {}
+
+        CashFlow operator*() const {
+            double amount = period == periods ? coupon + face_value : coupon;
+            return {period, static_cast<double>(period) / payment_frequency, amount};
+        }
+
+        iterator& operator++() {
+            ++period;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++period;
+            return previous;
+        }
+
+        bool operator==(const iterator& other) const {
+            return period == other.period;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return period != other.period;
+        }
+
+    private:
+        double coupon;
+        double face_value;
+        int periods;
+        int payment_frequency;
+        int period;
+    };
+
+    CashFlowSchedule(double coupon, double face_value, int periods, int payment_frequency)
+        : coupon(coupon), face_value(face_value), periods(periods), payment_frequency(payment_frequency) {}
+
+    iterator begin() const {
+        return iterator(*this, 1);
+    }
+
+    iterator end() const {
+        return iterator(*this, periods > 0 ? periods + 1 : 1);
+    }
+
+    std::size_t size() const {
+        return periods > 0 ? periods : 0;
+    }
+
+private:
+    double coupon;
+    double face_value;
+    int periods;
+    int payment_frequency;
+};
+
+// One safeguarded Halley step of a yield search. `diff` is price minus target
+// at `y`, `slope` and `curve` the first and second price derivatives there.
+// [low, high] brackets the root and shrinks as the search goes; steps leaving
+// it fall back to bisection, or to doubling outwards while there is no upper
+// bound yet. Returns false once the yield stops moving. That alone does not
+// mean a root was found: only a bracket that tightened from both sides does
+// (see bracketed_root).
+inline bool halley_update(double& y, double& low, double& high, double diff, double slope, double curve) {
+    if (diff > 0) {
+        low = y;
+    } else {
+        high = y;
+    }
+
+    double step = -diff / slope;
+    double halley = 1 + step * curve / (2 * slope);
+    if (halley > 0.5) {
+        step /= halley;
+    }
+
+    double next = y + step;
+    if (!(next > low && next < high)) {
+        next = high == HUGE_VAL ? y + 2 * (1 + fabs(y)) : (low + high) / 2;
+    }
+    bool moved = fabs(next - y) > 1e-15 * (1 + fabs(y));
+    y = next;
+    return moved;
+}
+
+// True when halley_update has moved both ends of the bracket in from where the
+// search started, i.e. the price crossed the target between low and high.
+inline bool bracketed_root(double low, double high, double start_low, double start_high) {
+    return low > start_low && high < start_high;
+}
 
 class Bond {
 public:
     double face_value;
     double coupon_rate;
     double market_price;
-    int remaining_years; // Remaining years to maturity
-    int payment_frequency;
-    double required_yield;
+    int remaining_years; // Remaining years to maturity
+    int payment_frequency;
+    double required_yield;
+
+    Bond(double face_value, double coupon_rate, double market_price, int remaining_years, int payment_frequency, double required_yield = -1.0)
+        : face_value(face_value), coupon_rate(coupon_rate), market_price(market_price), remaining_years(remaining_years), payment_frequency(payment_frequency), required_yield(required_yield) {}
+
+    double calculate_coupon() const {
+        return face_value * coupon_rate / payment_frequency;
+    }
+
+    double calculate_present_value(double rate, PricingMode mode = PricingMode::ClosedForm) const {
+        double coupon = calculate_coupon();
+        int periods = remaining_years * payment_frequency;
+        double periodic_rate = rate / payment_frequency;
+
+        // log1p/expm1 keep the annuity factor accurate for small rates; only a
+        // (near) zero rate has to go through the loop.
+        if (mode == PricingMode::ClosedForm) {
+            if (fabs(periodic_rate) > 1e-12) {
+                double growth = periods * log1p(periodic_rate);
+                double annuity = -expm1(-growth) / periodic_rate;
+                return coupon * annuity + face_value * exp(-growth);
+            }
+            return present_value_of(face_value, coupon_rate, remaining_years, payment_frequency, rate);
+        }
+        if (mode == PricingMode::Vectorized) {
+            return cash_flow_sums(coupon, face_value, 1 / (1 + periodic_rate), remaining_years, payment_frequency).pv;
+        }
+
+        double pv = 0.0;
+        for (int t = 1; t <= periods; ++t) {
+            pv += coupon / discount_pow(1 + rate / payment_frequency, t);
+        }
+        pv += face_value / discount_pow(1 + rate / payment_frequency, periods);
+        return pv;
+    }
+
+    // Price at `rate` with its exact first and second derivatives with respect
+    // to `input`, from one forward-mode pass of present_value_of.
+    Dual2<double> present_value_sensitivity(double rate, Sensitivity input) const {
+        using D = Dual2<double>;
+        D face = input == Sensitivity::FaceValue ? D::variable(face_value) : D(face_value);
+        D coupon = input == Sensitivity::CouponRate ? D::variable(coupon_rate) : D(coupon_rate);
+        D yield = input == Sensitivity::Yield ? D::variable(rate) : D(rate);
+        return present_value_of(face, coupon, remaining_years, payment_frequency, yield);
+    }
+
+    // Yield the bond is priced at: required_yield, or the YTM when it is the
+    // -1 "solve from price" marker.
+    double pricing_yield() const {
+        return required_yield == -1.0 ? calculate_ytm() : required_yield;
+    }
+
+    // NaN when no yield reproduces the market price.
+    double calculate_ytm(double tol = 1e-6, int max_iter = 1000) const {
+        BOND_COUNT(ytm_calls, 1);
+        BOND_TIME_SCOPE(ytm_latency);
+        YieldSolution solution = solve_yield(market_price, approximate_yield(market_price), tol, max_iter);
+        return solution.converged ? solution.yield : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Textbook approximation, good enough as a starting point for solve_yield.
+    double approximate_yield(double price) const {
+        if (remaining_years <= 0 || price <= 0) {
+            return coupon_rate;
+        }
+        double annual_coupon = face_value * coupon_rate;
+        return (annual_coupon + (face_value - price) / remaining_years) / ((face_value + price) / 2);
+    }
+
+    // Halley iteration on the analytic price derivatives (see halley_update).
+    // Any yield above -payment_frequency can be found.
+    YieldSolution solve_yield(double target_price, double guess, double tol = 1e-6, int max_iter = 100) const {
+        double low = -payment_frequency; // Discount factors blow up here
+        YieldSolution result = solve_yield_in(target_price, guess > low ? guess : low / 2, low, HUGE_VAL, tol, max_iter);
+        BOND_RECORD_SOLVE(result.iterations, result.converged);
+        return result;
+    }
+
+    // Re-solves after the price moved from `previous_price`, where `previous`
+    // was solved. The guess is the previous yield moved by the first-order
+    // duration estimate, and the search starts in a tight bracket around it,
+    // widening to the full range only if that fails. Small moves typically
+    // converge in one or two iterations.
+    YieldSolution solve_yield_near(double target_price, const YieldSolution& previous, double previous_price,
+                                   double tol = 1e-6, int max_iter = 100) const {
+        double guess = previous.yield;
+        if (previous.duration > 0 && previous_price > 0) {
+            guess -= (target_price - previous_price) / (previous_price * previous.duration);
+        }
+        double window = 4 * fabs(guess - previous.yield) + 1e-3;
+        double low = std::max(guess - window, -static_cast<double>(payment_frequency));
+        if (!(guess > low)) {
+            return solve_yield(target_price, previous.yield, tol, max_iter);
+        }
+
+        YieldSolution result = solve_yield_in(target_price, guess, low, guess + window, tol, std::min(max_iter, 8));
+        if (!result.converged) {
+            int used = result.iterations;
+            result = solve_yield_in(target_price, result.yield, -payment_frequency, HUGE_VAL, tol, max_iter - used);
+            result.iterations += used;
+        }
+        BOND_RECORD_SOLVE(result.iterations, result.converged);
+        return result;
+    }
+
+    // Risk at required_yield, normalised like analytics() by the price at that
+    // yield rather than the market price.
+    double calculate_macaulay_duration() const {
+        return analytics(required_yield).macaulay_duration;
+    }
+
+    double calculate_modified_duration() const {
+        return analytics(required_yield).modified_duration;
+    }
+
+    double calculate_convexity() const {
+        return analytics(required_yield).convexity;
+    }
+
+    // Price and risk at `rate` from a single pass over the cash-flow schedule.
+    BondAnalytics analytics(double rate) const {
+        double discount = 1 / (1 + rate / payment_frequency);
+        CashFlowSums sums = cash_flow_sums(calculate_coupon(), face_value, discount, remaining_years, payment_frequency);
+        return analytics_from_sums(sums, discount, payment_frequency);
+    }
+
+    // Same as analytics(rate), reading discount factors from a shared cache.
+    BondAnalytics analytics(double rate, DiscountCache& cache) const {
+        int periods = remaining_years * payment_frequency;
+        DiscountCache::Factors factors = cache.factors(rate, payment_frequency, periods);
+        const double* df = factors->data();
+        double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0;
+
+        for (int t = 1; t <= periods; ++t) {
+            sum0 += df[t];
+            sum1 += t * df[t];
+            sum2 += t * (t + 1.0) * df[t];
+        }
+        double coupon = calculate_coupon();
+        double principal = face_value * df[periods];
+        CashFlowSums sums = {coupon * sum0 + principal, coupon * sum1 + periods * principal,
+                             coupon * sum2 + periods * (periods + 1.0) * principal};
+        return analytics_from_sums(sums, 1 / (1 + rate / payment_frequency), payment_frequency);
+    }
+
+    double calculate_current_yield() const {
+        return calculate_coupon() / market_price;
+    }
+
+    void display_price_sensitivity() const {
+        double yield_change = 0.005; // ±0.5%
+        std::cout << "Price Sensitivity Analysis:\n";
+        for (double i = -2 * yield_change; i <= 2 * yield_change; i += yield_change) {
+            double new_yield = required_yield + i;
+            double new_price = calculate_present_value(new_yield);
+            std::cout << "Yield: " << std::fixed << std::setprecision(4) << new_yield << " | Price: " << new_price << '\n';
+        }
+    }
+
+    // NaN when no yield reproduces `reference_price`.
+    double calculate_break_even_yield(double reference_price) const {
+        BOND_COUNT(break_even_calls, 1);
+        BOND_TIME_SCOPE(break_even_latency);
+        YieldSolution solution = solve_yield(reference_price, approximate_yield(reference_price));
+        return solution.converged ? solution.yield : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    void display_scenario_analysis() const {
+        double scenarios[] = {-0.02, -0.01, 0.0, 0.01, 0.02}; // ±2%, ±1%
+        std::cout << "Scenario Analysis:\n";
+        for (double delta : scenarios) {
+            double new_yield = required_yield + delta;
+            BondAnalytics scenario = analytics(new_yield);
+            std::cout << "Yield: " << std::fixed << std::setprecision(4) << new_yield << '\n';
+            std::cout << "Price: " << scenario.price << '\n';
+            std::cout << "Macaulay Duration: " << scenario.macaulay_duration << '\n';
+            std::cout << "Modified Duration: " << scenario.modified_duration << '\n';
+            std::cout << "Convexity: " << scenario.convexity << '\n';
+            std::cout << '\n';
+        }
+    }
+
+    // Price and risk at `rate` as if the bond paid frequencies[k] coupons a
+    // year, for k < count, without copying the bond. Results are per period of
+    // the respective frequency.
+    void frequency_sweep(double rate, const int* frequencies, std::size_t count, BondAnalytics* out) const {
+        double annual_coupon = face_value * coupon_rate;
+        for (std::size_t k = 0; k < count; ++k) {
+            int freq = frequencies[k];
+            double discount = 1 / (1 + rate / freq);
+            CashFlowSums sums = cash_flow_sums(annual_coupon / freq, face_value, discount, remaining_years, freq);
+            out[k] = analytics_from_sums(sums, discount, freq);
+        }
+    }
+
+    void display_frequency_analysis() const {
+        int frequencies[] = {1, 2, 4}; // Annual, Semi-Annual, Quarterly
+        BondAnalytics results[3];
+        frequency_sweep(required_yield, frequencies, 3, results);
+        std::cout << "Frequency Analysis:\n";
+        for (int k = 0; k < 3; ++k) {
+            int freq = frequencies[k];
+            std::cout << "Payment Frequency: " << (freq == 1 ? "Annual" : freq == 2 ? "Semi-Annual" : "Quarterly") << '\n';
+            std::cout << "Price: " << results[k].price << '\n';
+            std::cout << "Macaulay Duration: " << results[k].macaulay_duration << '\n';
+            std::cout << "Modified Duration: " << results[k].modified_duration << '\n';
+            std::cout << "Convexity: " << results[k].convexity << '\n';
+            std::cout << '\n';
+        }
+    }
+
+    CashFlowSchedule cash_flows() const {
+        return CashFlowSchedule(calculate_coupon(), face_value, remaining_years * payment_frequency, payment_frequency);
+    }
+
+    void display_amortization_schedule() const {
+        std::cout << "Amortization Schedule:\n";
+        for (CashFlow flow : cash_flows()) {
+            std::cout << "Period: " << flow.period << " | Payment Time: " << flow.time << " | Payment: " << flow.amount << '\n';
+        }
+    }
+
+    void calculate_required_yield() {
+        if (required_yield == -1.0) {
+            std::cout << "Calculating required yield (YTM) based on the market price..." << '\n';
+            required_yield = calculate_ytm();
+        }
+    }
+
+private:
+    // Halley iteration from `guess` within the bracket [low, high].
+    YieldSolution solve_yield_in(double target_price, double guess, double low, double high, double tol, int max_iter) const {
+        const double start_low = low, start_high = high;
+        double y = guess;
+        YieldSolution result = {y, 0, false, 0.0};
+        for (int i = 1; i <= max_iter && !result.converged; ++i) {
+            BondAnalytics a = analytics(y);
+            double diff = a.price - target_price;
+            result.iterations = i;
+            result.duration = a.modified_duration / payment_frequency;
+            if (fabs(diff) < tol) {
+                result.converged = true;
+            } else {
+                double slope = -a.dv01 * 1e4;
+                double curve = a.convexity * a.price / (payment_frequency * payment_frequency);
+                if (!halley_update(y, low, high, diff, slope, curve)) {
+                    // Stalled: only a root if the price crossed the target.
+                    result.converged = bracketed_root(low, high, start_low, start_high);
+                    break;
+                }
+            }
+        }
+        result.yield = y;
+        return result;
+    }
+};
+
+struct RepriceResult {
+    double price;
+    double error_bound; // Certified bound on |price - exact price|, 0 when exact
+    bool exact;
+};
+
+// Keeps the last exact valuation of one bond and reprices small yield moves
+// with a second-order Taylor expansion around it. The remainder is bounded by
+// max |P'''| |dy|^3 / 6; |P'''| peaks at the lower of the two yields and is
+// bounded there from P'' via t + 2 <= n + 2 and (v_lo / v)^t <= (v_lo / v)^(n + 2).
+// Moves whose bound exceeds the tolerance are repriced exactly and become the
+// new expansion point.
+class IncrementalPricer {
+public:
+    IncrementalPricer(const Bond& bond, double yield, double tolerance = 1e-6)
+        : bond(bond), tolerance(tolerance) {
+        reset(yield);
+    }
+
+    RepriceResult reprice(double new_yield) {
+        double freq = bond.payment_frequency;
+        int periods = bond.remaining_years * bond.payment_frequency;
+        double dy = new_yield - last_yield;
+        double lower = new_yield < last_yield ? new_yield : last_yield;
+
+        if (1 + lower / freq > 0) {
+            double ratio = (1 + last_yield / freq) / (1 + lower / freq);
+            double third = (periods + 2) / (freq + lower) * discount_pow(ratio, periods + 2) * curve;
+            // Allowance for the summation error of the exact prices themselves.
+            double rounding = (periods + 16) * DBL_EPSILON * last.price;
+            double bound = third * fabs(dy * dy * dy) / 6 + rounding;
+            if (bound <= tolerance) {
+                return {last.price + slope * dy + 0.5 * curve * dy * dy, bound, false};
+            }
+        }
+
+        reset(new_yield);
+        return {last.price, 0.0, true};
+    }
+
+    double yield() const {
+        return last_yield;
+    }
+
+    // Exact analytics at yield().
+    const BondAnalytics& analytics() const {
+        return last;
+    }
+
+private:
+    Bond bond;
+    double tolerance;
+    double last_yield;
+    BondAnalytics last;
+    double slope; // dP/dy at last_yield
+    double curve; // d2P/dy2 at last_yield
+
+    void reset(double yield) {
+        double freq = bond.payment_frequency;
+        last_yield = yield;
+        last = bond.analytics(yield);
+        slope = -last.dv01 * 1e4;
+        curve = last.convexity * last.price / (freq * freq);
+    }
+};
+
+// Allocator handing out cache-line aligned storage, so batch loops over the
+// columns start on a fresh line and can use aligned vector loads.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Read-only view over a universe stored column by column. Batch entry points
+// take half-open [begin, end) ranges so callers can split the work.
+struct BondColumns {
+    const double* face_value;
+    const double* coupon_rate;
+    const double* market_price;
+    const int* remaining_years;
+    const int* payment_frequency;
+    const double* required_yield;
+    std::size_t size;
+
+    Bond bond(std::size_t i) const {
+        return Bond(face_value[i], coupon_rate[i], market_price[i], remaining_years[i], payment_frequency[i], required_yield[i]);
+    }
+
+    double pricing_yield(std::size_t i) const {
+        return bond(i).pricing_yield();
+    }
+
+    void price_all(std::size_t begin, std::size_t end, double* prices) const {
+        for (std::size_t i = begin; i < end; ++i) {
+            prices[i] = bond(i).calculate_present_value(pricing_yield(i));
+        }
+    }
+
+    void ytm_all(std::size_t begin, std::size_t end, double* yields) const {
+        ytm_batch(begin, end, yields, nullptr);
+    }
+
+    void risk_all(std::size_t begin, std::size_t end, BondAnalytics* risk, DiscountCache& cache) const {
+        for (std::size_t i = begin; i < end; ++i) {
+            risk[i] = bond(i).analytics(pricing_yield(i), cache);
+        }
+    }
+
+    // Calls visit(i, flow) for every cash flow of bonds [begin, end), bond by
+    // bond in schedule order, without materialising the schedules.
+    template <typename Visitor>
+    void for_each_cash_flow(std::size_t begin, std::size_t end, Visitor visit) const {
+        for (std::size_t i = begin; i < end; ++i) {
+            for (CashFlow flow : bond(i).cash_flows()) {
+                visit(i, flow);
+            }
+        }
+    }
+
+    // Bond::frequency_sweep for every bond in [begin, end) at its
+    // pricing_yield. Results for bond i and frequency k land at
+    // out[i * count + k]; each frequency runs a block of bonds through the
+    // SIMD lanes kernel.
+    void frequency_sweep_all(std::size_t begin, std::size_t end, const int* frequencies, std::size_t count,
+                             BondAnalytics* out) const {
+        constexpr std::size_t block = 256;
+        double annual_coupon[block], yield[block], coupon[block], face[block], discount[block], pv[block], weighted[block], curvature[block];
+        int periods[block];
+        const SimdKernels& kernels = simd_kernels();
+
+        for (std::size_t first = begin; first < end; first += block) {
+            std::size_t n = end - first < block ? end - first : block;
+            for (std::size_t j = 0; j < n; ++j) {
+                annual_coupon[j] = face_value[first + j] * coupon_rate[first + j];
+                yield[j] = pricing_yield(first + j);
+                face[j] = face_value[first + j];
+            }
+            for (std::size_t k = 0; k < count; ++k) {
+                int freq = frequencies[k];
+                for (std::size_t j = 0; j < n; ++j) {
+                    coupon[j] = annual_coupon[j] / freq;
+                    discount[j] = 1 / (1 + yield[j] / freq);
+                    periods[j] = remaining_years[first + j] * freq;
+                }
+                kernels.lanes(coupon, face, discount, periods, n, pv, weighted, curvature);
+                for (std::size_t j = 0; j < n; ++j) {
+                    out[(first + j) * count + k] = analytics_from_sums({pv[j], weighted[j], curvature[j]}, discount[j], freq);
+                }
+            }
+        }
+    }
+
+    // Solves market-price yields in lockstep groups of lane_count bonds. Each
+    // round runs the still-active lanes through the SIMD lanes kernel and takes
+    // one halley_update per lane; converged lanes are masked out of later
+    // rounds. Bonds with no solution get a NaN yield. `converged` may be null.
+    void ytm_batch(std::size_t begin, std::size_t end, double* yields, unsigned char* converged,
+                   double tol = 1e-6, int max_iter = 100) const {
+        constexpr std::size_t lane_count = 16;
+        double y[lane_count], low[lane_count], high[lane_count];
+        bool solved[lane_count];
+        double coupon[lane_count], face[lane_count], discount[lane_count];
+        double pv[lane_count], weighted[lane_count], curvature[lane_count];
+        int periods[lane_count];
+        std::size_t active[lane_count];
+        const SimdKernels& kernels = simd_kernels();
+
+        for (std::size_t first = begin; first < end; first += lane_count) {
+            std::size_t count = end - first < lane_count ? end - first : lane_count;
+            for (std::size_t k = 0; k < count; ++k) {
+                std::size_t i = first + k;
+                low[k] = -payment_frequency[i];
+                high[k] = HUGE_VAL;
+                y[k] = bond(i).approximate_yield(market_price[i]);
+                y[k] = y[k] > low[k] ? y[k] : low[k] / 2;
+                active[k] = k;
+                solved[k] = false;
+            }
+
+            std::size_t live = count;
+            for (int iter = 0; iter < max_iter && live > 0; ++iter) {
+                for (std::size_t j = 0; j < live; ++j) {
+                    std::size_t i = first + active[j];
+                    coupon[j] = face_value[i] * coupon_rate[i] / payment_frequency[i];
+                    face[j] = face_value[i];
+                    discount[j] = 1 / (1 + y[active[j]] / payment_frequency[i]);
+                    periods[j] = remaining_years[i] * payment_frequency[i];
+                }
+                kernels.lanes(coupon, face, discount, periods, live, pv, weighted, curvature);
+
+                std::size_t still_live = 0;
+                for (std::size_t j = 0; j < live; ++j) {
+                    std::size_t k = active[j];
+                    double freq = payment_frequency[first + k];
+                    double diff = pv[j] - market_price[first + k];
+                    bool found = fabs(diff) < tol;
+                    if (!found) {
+                        double slope = -weighted[j] * discount[j] / freq;
+                        double curve = curvature[j] * discount[j] * discount[j] / (freq * freq);
+                        if (halley_update(y[k], low[k], high[k], diff, slope, curve)) {
+                            active[still_live++] = k;
+                            continue;
+                        }
+                        found = bracketed_root(low[k], high[k], -freq, HUGE_VAL);
+                    }
+                    BOND_RECORD_SOLVE(iter + 1, found);
+                    solved[k] = found;
+                }
+                live = still_live;
+            }
+            for (std::size_t j = 0; j < live; ++j) {
+                BOND_RECORD_SOLVE(max_iter, false);
+            }
+
+            for (std::size_t k = 0; k < count; ++k) {
+                yields[first + k] = solved[k] ? y[k] : std::numeric_limits<double>::quiet_NaN();
+                if (converged) {
+                    converged[first + k] = solved[k];
+                }
+            }
+        }
+    }
+
+    // Runs the bonds through the SIMD lanes kernel a block at a time.
+    void risk_all(std::size_t begin, std::size_t end, BondAnalytics* risk) const {
+        constexpr std::size_t block = 256;
+        double coupon[block], face[block], discount[block], pv[block], weighted[block], curvature[block];
+        int periods[block];
+        const SimdKernels& kernels = simd_kernels();
+
+        for (std::size_t first = begin; first < end; first += block) {
+            std::size_t count = end - first < block ? end - first : block;
+            for (std::size_t k = 0; k < count; ++k) {
+                std::size_t i = first + k;
+                coupon[k] = face_value[i] * coupon_rate[i] / payment_frequency[i];
+                face[k] = face_value[i];
+                discount[k] = 1 / (1 + pricing_yield(i) / payment_frequency[i]);
+                periods[k] = remaining_years[i] * payment_frequency[i];
+            }
+            kernels.lanes(coupon, face, discount, periods, count, pv, weighted, curvature);
+            for (std::size_t k = 0; k < count; ++k) {
+                risk[first + k] = analytics_from_sums({pv[k], weighted[k], curvature[k]}, discount[k], payment_frequency[first + k]);
+            }
+        }
+    }
+};
+
+// Structure-of-arrays container for whole bond universes.
+class BondBook {
+public:
+    AlignedVector<double> face_value;
+    AlignedVector<double> coupon_rate;
+    AlignedVector<double> market_price;
+    AlignedVector<int> remaining_years;
+    AlignedVector<int> payment_frequency;
+    AlignedVector<double> required_yield;
+
+    std::size_t size() const {
+        return face_value.size();
+    }
+
+    void reserve(std::size_t n) {
+        face_value.reserve(n);
+        coupon_rate.reserve(n);
+        market_price.reserve(n);
+        remaining_years.reserve(n);
+        payment_frequency.reserve(n);
+        required_yield.reserve(n);
+    }
+
+    void add(const Bond& bond) {
+        face_value.push_back(bond.face_value);
+        coupon_rate.push_back(bond.coupon_rate);
+        market_price.push_back(bond.market_price);
+        remaining_years.push_back(bond.remaining_years);
+        payment_frequency.push_back(bond.payment_frequency);
+        required_yield.push_back(bond.required_yield);
+    }
+
+    Bond bond(std::size_t i) const {
+        return columns().bond(i);
+    }
+
+    BondColumns columns() const {
+        return {face_value.data(), coupon_rate.data(), market_price.data(), remaining_years.data(),
+                payment_frequency.data(), required_yield.data(), size()};
+    }
+
+    // Output arrays must hold size() elements.
+    void price_all(double* prices) const {
+        columns().price_all(0, size(), prices);
+    }
+
+    void ytm_all(double* yields) const {
+        columns().ytm_all(0, size(), yields);
+    }
+
+    void risk_all(BondAnalytics* risk) const {
+        columns().risk_all(0, size(), risk);
+    }
+};
+
+// 32-byte bond record, two per cache line. Face value is stored as a float and
+// the schedule as 16- and 8-bit integers, so only bonds whose fields fit are
+// accepted (see pack_bond); rates and prices keep full double precision.
+struct alignas(32) PackedBond {
+    double coupon_rate;
+    double market_price;
+    double required_yield;
+    float face_value;
+    std::uint16_t remaining_years;
+    std::uint8_t payment_frequency;
+    std::uint8_t reserved;
+
+    Bond bond() const {
+        return Bond(face_value, coupon_rate, market_price, remaining_years, payment_frequency, required_yield);
+    }
+};
+
+static_assert(sizeof(PackedBond) == 32, "two packed bonds per cache line");
+
+// Returns false, leaving `packed` untouched, if `bond` would not round-trip:
+// a face value that is not exactly a float, or years/frequency out of range.
+inline bool pack_bond(const Bond& bond, PackedBond& packed) {
+    if (!(fabs(bond.face_value) <= FLT_MAX) || static_cast<float>(bond.face_value) != bond.face_value ||
+        bond.remaining_years < 0 || bond.remaining_years > UINT16_MAX ||
+        bond.payment_frequency < 1 || bond.payment_frequency > UINT8_MAX) {
+        return false;
+    }
+    packed = {bond.coupon_rate, bond.market_price, bond.required_yield, static_cast<float>(bond.face_value),
+              static_cast<std::uint16_t>(bond.remaining_years), static_cast<std::uint8_t>(bond.payment_frequency), 0};
+    return true;
+}
+
+// Append-only pool of PackedBonds in fixed-size, cache-line-aligned blocks.
+// Growing never moves existing records, so a very large universe loads
+// without the reallocation copies (and transient double footprint) of a
+// vector; clear() keeps the blocks for the next load.
+class BondArena {
+public:
+    static constexpr std::size_t block_bonds = 1 << 15; // 1 MiB per block
+
+    std::size_t size() const {
+        return count;
+    }
+
+    std::size_t capacity() const {
+        return blocks.size() * block_bonds;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    // Returns false, adding nothing, if the bond cannot be packed losslessly.
+    bool add(const Bond& bond) {
+        PackedBond packed;
+        if (!pack_bond(bond, packed)) {
+            return false;
+        }
+        if (count == capacity()) {
+            blocks.emplace_back(Allocator().allocate(block_bonds));
+        }
+        blocks[count / block_bonds].get()[count % block_bonds] = packed;
+        ++count;
+        return true;
+    }
+
+    const PackedBond& operator[](std::size_t i) const {
+        return blocks[i / block_bonds].get()[i % block_bonds];
+    }
+
+    Bond bond(std::size_t i) const {
+        return (*this)[i].bond();
+    }
+
+    // `prices` must hold size() elements.
+    void price_all(double* prices) const {
+        for (std::size_t first = 0; first < count; first += block_bonds) {
+            const PackedBond* block = blocks[first / block_bonds].get();
+            std::size_t n = std::min(block_bonds, count - first);
+            for (std::size_t i = 0; i < n; ++i) {
+                Bond bond = block[i].bond();
+                prices[first + i] = bond.calculate_present_value(bond.pricing_yield());
+            }
+        }
+    }
+
+private:
+    using Allocator = AlignedAllocator<PackedBond, 64>;
+
+    struct BlockDeleter {
+        void operator()(PackedBond* block) const {
+            Allocator().deallocate(block, block_bonds);
+        }
+    };
+
+    std::vector<std::unique_ptr<PackedBond, BlockDeleter>> blocks;
+    std::size_t count = 0;
+};
+
+// Fixed-size worker pool with one deque per worker. Owners pop from the back
+// of their own deque and idle workers steal from the front of the others, so
+// uneven chunks (long and short schedules) still balance out.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency())
+        : queues(threads ? threads : 1) {
+        for (unsigned i = 0; i < queues.size(); ++i) {
+            workers.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        sleep_cv.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    // Calls body(begin, end) over [0, count) in chunks of at most `grain` and
+    // returns once every chunk has run. The calling thread helps out.
+    template <typename Body>
+    void parallel_for(std::size_t count, std::size_t grain, Body body) {
+        if (count == 0) {
+            return;
+        }
+        grain = grain ? grain : 1;
+        std::size_t chunks = (count + grain - 1) / grain;
+        std::function<void(std::size_t, std::size_t)> task(std::move(body));
+        Batch batch;
+        batch.remaining = chunks;
+
+        // Hand out contiguous runs of chunks so each worker starts on its own
+        // stretch of memory.
+        std::size_t per_queue = (chunks + queues.size() - 1) / queues.size();
+        for (std::size_t c = 0; c < chunks; ++c) {
+            std::size_t begin = c * grain;
+            std::size_t end = begin + grain < count ? begin + grain : count;
+            WorkQueue& queue = queues[c / per_queue];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back({&task, begin, end, &batch});
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            queued += chunks;
+        }
+        sleep_cv.notify_all();
+
+        Job job;
+        while (batch.remaining.load(std::memory_order_acquire) > 0) {
+            if (steal(queues.size(), job)) {
+                run(job);
+            } else {
+                std::unique_lock<std::mutex> lock(batch.mutex);
+                batch.done.wait(lock, [&] { return batch.remaining.load(std::memory_order_acquire) == 0; });
+            }
+        }
+        // The last worker still holds the batch mutex while it notifies.
+        std::lock_guard<std::mutex> lock(batch.mutex);
+    }
+
+private:
+    struct Batch {
+        std::atomic<std::size_t> remaining{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    struct Job {
+        const std::function<void(std::size_t, std::size_t)>* task;
+        std::size_t begin;
+        std::size_t end;
+        Batch* batch;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    std::size_t queued = 0; // Jobs sitting in any deque, guarded by sleep_mutex
+    bool stopping = false;
+
+    bool pop_local(std::size_t self, Job& job) {
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    // Takes the oldest job from any deque other than `self`.
+    bool steal(std::size_t self, Job& job) {
+        for (std::size_t k = 1; k <= queues.size(); ++k) {
+            std::size_t victim = (self + k) % queues.size();
+            if (victim == self) {
+                continue;
+            }
+            WorkQueue& queue = queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = queue.jobs.front();
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(const Job& job) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            --queued;
+        }
+        (*job.task)(job.begin, job.end);
+        std::lock_guard<std::mutex> lock(job.batch->mutex);
+        if (job.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            job.batch->done.notify_all();
+        }
+    }
+
+    void worker_loop(std::size_t self) {
+        Job job;
+        while (true) {
+            if (pop_local(self, job) || steal(self, job)) {
+                run(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+};
+
+// Prices a whole universe on a ThreadPool: every bond gets its YTM, then price
+// and risk at the required yield (or at the YTM when none was given).
+class PortfolioEngine {
+public:
+    explicit PortfolioEngine(ThreadPool& pool, std::size_t chunk_size = 1024)
+        : pool(pool), chunk_size(chunk_size) {}
+
+    // Output arrays must hold book.size elements.
+    void run(const BondColumns& book, double* ytm, double* price, BondAnalytics* risk) {
+        pool.parallel_for(book.size, chunk_size, [&](std::size_t begin, std::size_t end) {
+            book.ytm_batch(begin, end, ytm, nullptr);
+            for (std::size_t i = begin; i < end; ++i) {
+                double yield = book.required_yield[i] == -1.0 ? ytm[i] : book.required_yield[i];
+                risk[i] = book.bond(i).analytics(yield);
+                price[i] = risk[i].price;
+            }
+        });
+    }
+
+private:
+    ThreadPool& pool;
+    std::size_t chunk_size;
+};
+
+// Streams bonds from CSV text, one record per line:
+//   face_value,coupon_rate,market_price,remaining_years,payment_frequency[,required_yield]
+// Input is read in large blocks and parsed in place with std::from_chars, so no
+// allocation happens per record. Blank lines and lines starting with '#' are
+// skipped; malformed lines (including a header row) are counted and skipped.
+class BondCsvReader {
+public:
+    explicit BondCsvReader(std::FILE* in, std::size_t buffer_size = 1 << 20)
+        : in(in), buffer(buffer_size) {}
+
+    bool next(Bond& bond) {
+        while (true) {
+            const char* line_end = static_cast<const char*>(std::memchr(buffer.data() + begin, '\n', end - begin));
+            if (!line_end) {
+                if (!refill()) {
+                    if (begin == end) {
+                        return false;
+                    }
+                    line_end = buffer.data() + end; // Last line without a newline
+                } else {
+                    continue;
+                }
+            }
+            const char* line = buffer.data() + begin;
+            begin = line_end - buffer.data() + (line_end < buffer.data() + end ? 1 : 0);
+            ++line_number_;
+            if (line_end > line && line_end[-1] == '\r') {
+                --line_end;
+            }
+            if (line == line_end || *line == '#') {
+                continue;
+            }
+            if (parse(line, line_end, bond)) {
+                return true;
+            }
+            ++malformed_;
+        }
+    }
+
+    std::size_t line_number() const {
+        return line_number_;
+    }
+
+    std::size_t malformed() const {
+        return malformed_;
+    }
+
+private:
+    std::FILE* in;
+    std::vector<char> buffer;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t line_number_ = 0;
+    std::size_t malformed_ = 0;
+
+    // Moves the unread tail to the front and appends the next block; the
+    // buffer only grows for lines longer than itself.
+    bool refill() {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        std::size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, in);
+        end += got;
+        return got > 0;
+    }
+
+    template <typename T>
+    static bool parse_field(const char*& p, const char* line_end, T& value) {
+        while (p < line_end && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+        std::from_chars_result parsed = std::from_chars(p, line_end, value);
+        if (parsed.ec != std::errc()) {
+            return false;
+        }
+        p = parsed.ptr;
+        while (p < line_end && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+        if (p < line_end && *p == ',') {
+            ++p;
+            return p < line_end; // A separator must be followed by a field
+        }
+        return p == line_end;
+    }
+
+    static bool parse(const char* p, const char* line_end, Bond& bond) {
+        if (!parse_field(p, line_end, bond.face_value) || !parse_field(p, line_end, bond.coupon_rate) ||
+            !parse_field(p, line_end, bond.market_price) || !parse_field(p, line_end, bond.remaining_years) ||
+            !parse_field(p, line_end, bond.payment_frequency) || bond.payment_frequency <= 0) {
+            return false;
+        }
+        bond.required_yield = -1.0;
+        return p == line_end || (parse_field(p, line_end, bond.required_yield) && p == line_end);
+    }
+};
+
+// Dense scenario x bond results. Each matrix is stored scenario-major, so the
+// value for scenario s and bond b sits at [s * bonds + b].
+struct ScenarioGrid {
+    std::size_t scenarios = 0;
+    std::size_t bonds = 0;
+    AlignedVector<double> price;
+    AlignedVector<double> macaulay_duration;
+    AlignedVector<double> modified_duration;
+    AlignedVector<double> convexity;
+    AlignedVector<double> dv01;
+
+    void resize(std::size_t scenario_count, std::size_t bond_count) {
+        scenarios = scenario_count;
+        bonds = bond_count;
+        price.resize(scenarios * bonds);
+        macaulay_duration.resize(scenarios * bonds);
+        modified_duration.resize(scenarios * bonds);
+        convexity.resize(scenarios * bonds);
+        dv01.resize(scenarios * bonds);
+    }
+};
+
+// Revalues a book under parallel yield shocks: scenario s prices every bond at
+// its pricing_yield + shocks[s], with duration and convexity taken at the
+// shocked yield. Tiles of bonds are spread over the pool; each tile is walked
+// in stack blocks whose inputs stay in cache while the block is run through
+// every scenario with the SIMD lanes kernel.
+class ScenarioEngine {
+public:
+    explicit ScenarioEngine(ThreadPool& pool, std::size_t tile_bonds = 256)
+        : pool(pool), tile_bonds(tile_bonds ? tile_bonds : 1) {}
+
+    void run(const BondColumns& book, const std::vector<double>& shocks, ScenarioGrid& grid) {
+        grid.resize(shocks.size(), book.size);
+        const SimdKernels& kernels = simd_kernels();
+
+        pool.parallel_for(book.size, tile_bonds, [&](std::size_t begin, std::size_t end) {
+            constexpr std::size_t block = 256;
+            double coupon[block], face[block], base_yield[block], discount[block], pv[block], weighted[block], curvature[block];
+            int periods[block];
+
+            for (std::size_t first = begin; first < end; first += block) {
+                std::size_t count = end - first < block ? end - first : block;
+                for (std::size_t k = 0; k < count; ++k) {
+                    std::size_t i = first + k;
+                    coupon[k] = book.face_value[i] * book.coupon_rate[i] / book.payment_frequency[i];
+                    face[k] = book.face_value[i];
+                    base_yield[k] = book.pricing_yield(i);
+                    periods[k] = book.remaining_years[i] * book.payment_frequency[i];
+                }
+
+                for (std::size_t s = 0; s < shocks.size(); ++s) {
+                    for (std::size_t k = 0; k < count; ++k) {
+                        discount[k] = 1 / (1 + (base_yield[k] + shocks[s]) / book.payment_frequency[first + k]);
+                    }
+                    kernels.lanes(coupon, face, discount, periods, count, pv, weighted, curvature);
+
+                    std::size_t row = s * grid.bonds + first;
+                    for (std::size_t k = 0; k < count; ++k) {
+                        BondAnalytics risk = analytics_from_sums({pv[k], weighted[k], curvature[k]}, discount[k], book.payment_frequency[first + k]);
+                        grid.price[row + k] = risk.price;
+                        grid.macaulay_duration[row + k] = risk.macaulay_duration;
+                        grid.modified_duration[row + k] = risk.modified_duration;
+                        grid.convexity[row + k] = risk.convexity;
+                        grid.dv01[row + k] = risk.dv01;
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    ThreadPool& pool;
+    std::size_t tile_bonds;
+};
+
+// Binary bond universe, version 1: a fixed header followed by one column per
+// Bond field, each starting on a 64-byte boundary, in native (little-endian)
+// byte order. Loaders map the file and price straight from the columns.
+struct BondUniverseHeader {
+    char magic[8];               // "BONDUNIV"
+    std::uint32_t version;
+    std::uint32_t header_size;   // sizeof(BondUniverseHeader) for this version
+    std::uint64_t count;
+    std::uint64_t column_offset[6]; // face_value, coupon_rate, market_price, remaining_years, payment_frequency, required_yield
+};
+
+constexpr char bond_universe_magic[8] = {'B', 'O', 'N', 'D', 'U', 'N', 'I', 'V'};
+constexpr std::uint32_t bond_universe_version = 1;
+
+inline std::uint64_t bond_universe_layout(std::uint64_t count, std::uint64_t* column_offset) {
+    const std::uint64_t widths[6] = {sizeof(double), sizeof(double), sizeof(double), sizeof(int), sizeof(int), sizeof(double)};
+    std::uint64_t offset = sizeof(BondUniverseHeader);
+    for (int c = 0; c < 6; ++c) {
+        offset = (offset + 63) / 64 * 64;
+        column_offset[c] = offset;
+        offset += count * widths[c];
+    }
+    return offset;
+}
+
+inline bool write_bond_universe(const char* path, const BondColumns& book) {
+    BondUniverseHeader header = {};
+    std::memcpy(header.magic, bond_universe_magic, sizeof header.magic);
+    header.version = bond_universe_version;
+    header.header_size = sizeof(BondUniverseHeader);
+    header.count = book.size;
+    bond_universe_layout(book.size, header.column_offset);
+
+    std::FILE* out = std::fopen(path, "wb");
+    if (!out) {
+        return false;
+    }
+    const void* columns[6] = {book.face_value, book.coupon_rate, book.market_price, book.remaining_years,
+                              book.payment_frequency, book.required_yield};
+    const std::size_t widths[6] = {sizeof(double), sizeof(double), sizeof(double), sizeof(int), sizeof(int), sizeof(double)};
+    static const char padding[64] = {};
+    bool ok = std::fwrite(&header, sizeof header, 1, out) == 1;
+    std::uint64_t written = sizeof header;
+    for (int c = 0; c < 6 && ok; ++c) {
+        ok = std::fwrite(padding, 1, header.column_offset[c] - written, out) == header.column_offset[c] - written &&
+             std::fwrite(columns[c], widths[c], book.size, out) == book.size;
+        written = header.column_offset[c] + widths[c] * book.size;
+    }
+    return std::fclose(out) == 0 && ok;
+}
+
+// Read-only memory mapping of a binary bond universe.
+class MappedBondUniverse {
+public:
+    MappedBondUniverse() = default;
+    MappedBondUniverse(const MappedBondUniverse&) = delete;
+    MappedBondUniverse& operator=(const MappedBondUniverse&) = delete;
+
+    ~MappedBondUniverse() {
+        close();
+    }
+
+    // On failure returns false and leaves the reason in error().
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            error_ = "cannot open file";
+            return false;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(BondUniverseHeader))) {
+            ::close(fd);
+            error_ = "file too small for a header";
+            return false;
+        }
+        void* mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            error_ = "mmap failed";
+            return false;
+        }
+        data = static_cast<const char*>(mapped);
+        length = info.st_size;
+        ::madvise(mapped, length, MADV_SEQUENTIAL);
+
+        const BondUniverseHeader* header = reinterpret_cast<const BondUniverseHeader*>(data);
+        std::uint64_t expected[6];
+        if (std::memcmp(header->magic, bond_universe_magic, sizeof header->magic) != 0) {
+            error_ = "not a bond universe file";
+        } else if (header->version != bond_universe_version || header->header_size != sizeof(BondUniverseHeader)) {
+            error_ = "unsupported format version";
+        } else if (header->count > length || bond_universe_layout(header->count, expected) > length ||
+                   std::memcmp(expected, header->column_offset, sizeof expected) != 0) {
+            error_ = "column layout does not match the file";
+        } else {
+            count = header->count;
+            std::memcpy(offsets, header->column_offset, sizeof offsets);
+            return true;
+        }
+        close();
+        return false;
+    }
+
+    void close() {
+        if (data) {
+            ::munmap(const_cast<char*>(data), length);
+        }
+        data = nullptr;
+        length = 0;
+        count = 0;
+    }
+
+    const char* error() const {
+        return error_;
+    }
+
+    BondColumns columns() const {
+        return {column<double>(0), column<double>(1), column<double>(2), column<int>(3), column<int>(4),
+                column<double>(5), static_cast<std::size_t>(count)};
+    }
+
+private:
+    const char* data = nullptr;
+    std::size_t length = 0;
+    std::uint64_t count = 0;
+    std::uint64_t offsets[6] = {};
+    const char* error_ = "";
+
+    template <typename T>
+    const T* column(int c) const {
+        return reinterpret_cast<const T*>(data + offsets[c]);
+    }
+};
+
+enum class OutputFormat { Csv, JsonLines, Binary };
+
+// Buffered sink for per-bond analytics records. Records are formatted into one
+// reusable buffer (doubles as shortest round-trip text via std::to_chars) that
+// goes to the file descriptor only when full or on flush(), so a million rows
+// cost a handful of write calls. Binary records are the six doubles
+// ytm, price, macaulay, modified, convexity, dv01 in native byte order.
+class ReportWriter {
+public:
+    explicit ReportWriter(int fd, OutputFormat format, std::size_t buffer_size = 1 << 20)
+        : fd(fd), format(format), buffer(buffer_size < 512 ? 512 : buffer_size) {}
+
+    ~ReportWriter() {
+        flush();
+    }
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    void header() {
+        if (format == OutputFormat::Csv) {
+            append("ytm,price,macaulay_duration,modified_duration,convexity,dv01\n");
+        }
+    }
+
+    void record(double ytm, const BondAnalytics& a) {
+        reserve(384); // Longest text record is well under this
+        if (format == OutputFormat::Binary) {
+            const double fields[6] = {ytm, a.price, a.macaulay_duration, a.modified_duration, a.convexity, a.dv01};
+            std::memcpy(buffer.data() + used, fields, sizeof fields);
+            used += sizeof fields;
+        } else if (format == OutputFormat::JsonLines) {
+            append("{\"ytm\":");
+            json_number(ytm);
+            append(",\"price\":");
+            json_number(a.price);
+            append(",\"macaulay_duration\":");
+            json_number(a.macaulay_duration);
+            append(",\"modified_duration\":");
+            json_number(a.modified_duration);
+            append(",\"convexity\":");
+            json_number(a.convexity);
+            append(",\"dv01\":");
+            json_number(a.dv01);
+            append("}\n");
+        } else {
+            number(ytm);
+            buffer[used++] = ',';
+            number(a.price);
+            buffer[used++] = ',';
+            number(a.macaulay_duration);
+            buffer[used++] = ',';
+            number(a.modified_duration);
+            buffer[used++] = ',';
+            number(a.convexity);
+            buffer[used++] = ',';
+            number(a.dv01);
+            buffer[used++] = '\n';
+        }
+    }
+
+    // Returns false if the descriptor rejected this or any earlier data; the
+    // errno of the first failure is kept in error().
+    bool flush() {
+        std::size_t done = 0;
+        while (done < used) {
+            ssize_t n = ::write(fd, buffer.data() + done, used - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                if (!failed) {
+                    error_ = n < 0 ? errno : EIO;
+                }
+                failed = true;
+                break;
+            }
+            done += n;
+        }
+        used = 0;
+        return !failed;
+    }
+
+    int error() const {
+        return error_;
+    }
+
+private:
+    int fd;
+    OutputFormat format;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool failed = false;
+    int error_ = 0;
+
+    void reserve(std::size_t bytes) {
+        if (buffer.size() - used < bytes) {
+            flush();
+        }
+    }
+
+    void append(const char* text) {
+        std::size_t length = std::strlen(text);
+        reserve(length);
+        std::memcpy(buffer.data() + used, text, length);
+        used += length;
+    }
+
+    void number(double value) {
+        std::to_chars_result written = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = written.ptr - buffer.data();
+    }
+
+    // JSON has no spelling for NaN or infinities.
+    void json_number(double value) {
+        if (std::isfinite(value)) {
+            number(value);
+        } else {
+            append("null");
+        }
+    }
+};
+
+inline bool parse_output_format(const char* name, OutputFormat& format) {
+    if (std::strcmp(name, "csv") == 0) {
+        format = OutputFormat::Csv;
+    } else if (std::strcmp(name, "jsonl") == 0) {
+        format = OutputFormat::JsonLines;
+    } else if (std::strcmp(name, "binary") == 0) {
+        format = OutputFormat::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Non-interactive mode: prices every record from `path` ("-" for stdin) and
+// writes one analytics record per input record to stdout as it goes.
+int run_batch(const char* path, OutputFormat format) {
+    std::FILE* in = std::strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+    if (!in) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+
+    ReportWriter writer(STDOUT_FILENO, format);
+    writer.header();
+    BondCsvReader reader(in);
+    Bond bond(0, 0, 0, 0, 1);
+    while (reader.next(bond)) {
+        double ytm = bond.calculate_ytm();
+        writer.record(ytm, bond.analytics(bond.required_yield == -1.0 ? ytm : bond.required_yield));
+    }
+    bool written = writer.flush();
+
+    if (in != stdin) {
+        std::fclose(in);
+    }
+    if (reader.malformed()) {
+        std::cerr << reader.malformed() << " malformed record(s) skipped\n";
+    }
+    if (!written) {
+        std::cerr << "Cannot write report: " << std::strerror(writer.error()) << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Wire format of the pricing server, native (little-endian) byte order. A
+// request frame is a FrameHeader with magic request_magic followed by `count`
+// WireBond records; the reply is a FrameHeader with response_magic and one
+// WireAnalytics per bond, in order. Clients may pipeline any number of frames
+// on one connection; replies come back in request order.
+struct FrameHeader {
+    std::uint32_t magic;
+    std::uint32_t count;
+};
+
+struct WireBond {
+    double face_value;
+    double coupon_rate;
+    double market_price;
+    double required_yield; // -1 to price at the YTM
+    std::int32_t remaining_years;
+    std::int32_t payment_frequency;
+};
 
-    Bond(double face_value, double coupon_rate, double market_price, int remaining_years, int payment_frequency, double required_yield = -1.0)
-        : face_value(face_value), coupon_rate(coupon_rate), market_price(market_price), remaining_years(remaining_years), payment_frequency(payment_frequency), required_yield(required_yield) {}
+struct WireAnalytics {
+    double ytm;
+    double price;
+    double macaulay_duration;
+    double modified_duration;
+    double convexity;
+    double dv01;
+};
 
-    double calculate_coupon() const {
-        return face_value * coupon_rate / payment_frequency;
+static_assert(sizeof(FrameHeader) == 8 && sizeof(WireBond) == 40 && sizeof(WireAnalytics) == 48, "wire layout");
+
+constexpr std::uint32_t request_magic = 0x51525042;  // "BPRQ"
+constexpr std::uint32_t response_magic = 0x53525042; // "BPRS"
+constexpr std::uint32_t max_frame_bonds = 1 << 20;
+constexpr std::size_t max_pending_output = 4 << 20; // Per connection; reading pauses beyond it
+constexpr int max_wire_periods = 1 << 14; // Longer schedules would stall the event loop
+
+inline volatile std::sig_atomic_t server_stop_requested = 0;
+
+// Single-threaded epoll server over a Unix domain socket. The engine stays
+// warm between requests, so a round trip costs socket I/O plus the pricing.
+class PricingServer {
+public:
+    ~PricingServer() {
+        for (auto& entry : connections) {
+            ::close(entry.first);
+        }
+        if (epoll_fd >= 0) {
+            ::close(epoll_fd);
+        }
+        if (listen_fd >= 0) {
+            ::close(listen_fd);
+            ::unlink(socket_path.c_str());
+        }
     }
 
-    double calculate_present_value(double rate) const {
-        double pv = 0.0;
-        double coupon = calculate_coupon();
-        int periods = remaining_years * payment_frequency;
+    // Binds `path`, replacing a stale socket file. Returns false with errno set.
+    bool listen(const char* path) {
+        sockaddr_un address = {};
+        if (std::strlen(path) >= sizeof address.sun_path) {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path);
+        ::unlink(path);
 
-        for (int t = 1; t <= periods; ++t) {
-            pv += coupon / pow(1 + rate / payment_frequency, t);
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0 || ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof address) != 0 ||
+            ::listen(listen_fd, SOMAXCONN) != 0) {
+            return false;
         }
-        pv += face_value / pow(1 + rate / payment_frequency, periods);
-        return pv;
+        socket_path = path;
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        return epoll_fd >= 0 && watch(listen_fd, EPOLLIN);
     }
 
-    double calculate_ytm(double tol = 1e-6, int max_iter = 1000) const {
-        double low = 0.0, high = 1.0;
-        double mid = 0.0;
+    // Serves until server_stop_requested is set (SIGINT/SIGTERM).
+    void run() {
+        epoll_event events[64];
+        while (!server_stop_requested) {
+            int ready = ::epoll_wait(epoll_fd, events, 64, -1);
+            for (int e = 0; e < ready; ++e) {
+                int fd = events[e].data.fd;
+                if (fd == listen_fd) {
+                    accept_all();
+                } else if (!service(fd, events[e].events)) {
+                    drop(fd);
+                }
+            }
+        }
+    }
 
-        for (int i = 0; i < max_iter; ++i) {
-            mid = (low + high) / 2.0;
-            double pv = calculate_present_value(mid);
-            double diff = market_price - pv;
+private:
+    struct Connection {
+        std::vector<char> in;
+        std::vector<char> out;
+        std::size_t out_sent = 0;
+        bool peer_closed = false; // Half-closed by the client: answer, drain, then close
 
-            if (fabs(diff) < tol) {
-                return mid;
+        bool wants_input() const {
+            return !peer_closed && out.size() - out_sent < max_pending_output;
+        }
+    };
+
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    std::string socket_path;
+    std::unordered_map<int, Connection> connections;
+
+    bool watch(int fd, std::uint32_t events, int op = EPOLL_CTL_ADD) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.fd = fd;
+        return ::epoll_ctl(epoll_fd, op, fd, &event) == 0;
+    }
+
+    void accept_all() {
+        while (true) {
+            int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            if (!watch(fd, EPOLLIN)) {
+                ::close(fd);
+                continue;
+            }
+            connections[fd];
+        }
+    }
+
+    void drop(int fd) {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    }
+
+    // Returns false when the connection should be closed. Reading stops while
+    // more than max_pending_output bytes of answers wait to be sent, so a
+    // client that does not read cannot grow the output buffer without bound.
+    bool service(int fd, std::uint32_t events) {
+        Connection& connection = connections[fd];
+        if (events & EPOLLIN) {
+            char chunk[64 * 1024];
+            while (connection.wants_input()) {
+                ssize_t n = ::recv(fd, chunk, sizeof chunk, 0);
+                if (n > 0) {
+                    connection.in.insert(connection.in.end(), chunk, chunk + n);
+                    if (!answer_frames(connection)) {
+                        return false;
+                    }
+                } else if (n == 0) {
+                    connection.peer_closed = true; // A trailing partial frame can never be answered
+                } else if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                } else {
+                    return false;
+                }
+            }
+        } else if (events & (EPOLLHUP | EPOLLERR)) {
+            return false;
+        }
+        return flush(fd, connection);
+    }
+
+    // Answers every complete frame in the input buffer.
+    bool answer_frames(Connection& connection) {
+        std::size_t offset = 0;
+        while (connection.in.size() - offset >= sizeof(FrameHeader)) {
+            FrameHeader header;
+            std::memcpy(&header, connection.in.data() + offset, sizeof header);
+            if (header.magic != request_magic || header.count > max_frame_bonds) {
+                return false;
             }
+            std::size_t frame_size = sizeof header + header.count * sizeof(WireBond);
+            if (connection.in.size() - offset < frame_size) {
+                break;
+            }
+
+            FrameHeader reply = {response_magic, header.count};
+            std::size_t at = connection.out.size();
+            connection.out.resize(at + sizeof reply + header.count * sizeof(WireAnalytics));
+            std::memcpy(connection.out.data() + at, &reply, sizeof reply);
+            at += sizeof reply;
+            const char* records = connection.in.data() + offset + sizeof header;
+            for (std::uint32_t i = 0; i < header.count; ++i, at += sizeof(WireAnalytics)) {
+                WireBond wire;
+                std::memcpy(&wire, records + i * sizeof wire, sizeof wire);
+                WireAnalytics result = price_wire_bond(wire);
+                std::memcpy(connection.out.data() + at, &result, sizeof result);
+            }
+            offset += frame_size;
+        }
+        connection.in.erase(connection.in.begin(), connection.in.begin() + offset);
+        return true;
+    }
+
+    // Bonds with no schedule or one over max_wire_periods get a NaN record.
+    static WireAnalytics price_wire_bond(const WireBond& wire) {
+        if (wire.payment_frequency <= 0 || wire.remaining_years < 0 ||
+            wire.remaining_years > max_wire_periods / wire.payment_frequency) {
+            double nan = std::numeric_limits<double>::quiet_NaN();
+            return {nan, nan, nan, nan, nan, nan};
+        }
+        Bond bond(wire.face_value, wire.coupon_rate, wire.market_price, wire.remaining_years, wire.payment_frequency,
+                  wire.required_yield);
+        double ytm = bond.calculate_ytm();
+        BondAnalytics a = bond.analytics(bond.required_yield == -1.0 ? ytm : bond.required_yield);
+        return {ytm, a.price, a.macaulay_duration, a.modified_duration, a.convexity, a.dv01};
+    }
 
-            if (pv < market_price) {
-                high = mid;
+    // Sends as much pending output as the socket takes, and waits for
+    // EPOLLOUT only while something is left over. Once a half-closed
+    // connection has been fully answered it is closed.
+    bool flush(int fd, Connection& connection) {
+        while (connection.out_sent < connection.out.size()) {
+            ssize_t n = ::send(fd, connection.out.data() + connection.out_sent, connection.out.size() - connection.out_sent,
+                               MSG_NOSIGNAL);
+            if (n > 0) {
+                connection.out_sent += n;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                // Drop the sent prefix once it is most of the buffer, so a
+                // client that never quite catches up cannot grow it forever.
+                if (connection.out_sent > connection.out.size() / 2) {
+                    connection.out.erase(connection.out.begin(), connection.out.begin() + connection.out_sent);
+                    connection.out_sent = 0;
+                }
+                std::uint32_t wanted = EPOLLOUT;
+                if (connection.wants_input()) {
+                    wanted |= EPOLLIN;
+                }
+                return watch(fd, wanted, EPOLL_CTL_MOD);
             } else {
-                low = mid;
+                return false;
             }
         }
+        connection.out.clear();
+        connection.out_sent = 0;
+        return !connection.peer_closed && watch(fd, EPOLLIN, EPOLL_CTL_MOD);
+    }
+};
 
-        return mid;
+int run_server(const char* path) {
+    struct sigaction stop = {};
+    stop.sa_handler = [](int) { server_stop_requested = 1; };
+    ::sigaction(SIGINT, &stop, nullptr);
+    ::sigaction(SIGTERM, &stop, nullptr);
+
+    PricingServer server;
+    if (!server.listen(path)) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        return 1;
     }
+    std::cerr << "Serving on " << path << "\n";
+    server.run();
+    return 0;
+}
 
-    double calculate_macaulay_duration() const {
-        double duration = 0.0;
-        double coupon = calculate_coupon();
-        int periods = remaining_years * payment_frequency;
+struct Tick {
+    std::uint64_t bond_id; // Row in the bond universe
+    double price;
+};
 
-        for (int t = 1; t <= periods; ++t) {
-            duration += t * coupon / pow(1 + required_yield / payment_frequency, t);
+// Header of a single-producer/single-consumer tick ring in shared memory; the
+// slots follow on the next cache line. Each side owns one cache line holding
+// its index plus a cached copy of the other side's, and only re-reads the
+// other side's line when the cached copy says the ring looks full or empty.
+struct TickRingHeader {
+    std::atomic<std::uint64_t> magic; // Stored last by create(), once the ring is usable
+    std::uint64_t capacity; // Power of two
+    alignas(64) std::atomic<std::uint64_t> head;  // Next slot to write, producer-owned
+    std::uint64_t cached_tail;
+    alignas(64) std::atomic<std::uint64_t> tail;  // Next slot to read, consumer-owned
+    std::uint64_t cached_head;
+    alignas(64) std::atomic<std::uint32_t> producer_done;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ring indices must be address-free atomics");
+
+constexpr std::uint64_t tick_ring_magic = 0x474e495248434954; // "TICKRING"
+
+// POSIX shared-memory mapping of a tick ring. The pricer create()s it, the
+// feed attach()es; ticks are written straight into the shared slots, with no
+// pipe or socket copies in between.
+class SharedTickRing {
+public:
+    SharedTickRing() = default;
+    SharedTickRing(const SharedTickRing&) = delete;
+    SharedTickRing& operator=(const SharedTickRing&) = delete;
+
+    ~SharedTickRing() {
+        if (header) {
+            ::munmap(header, bytes_for(header->capacity));
+        }
+        if (owner) {
+            ::shm_unlink(name.c_str());
         }
-        duration += periods * face_value / pow(1 + required_yield / payment_frequency, periods);
-        return duration / market_price;
     }
 
-    double calculate_modified_duration() const {
-        double macaulay_duration = calculate_macaulay_duration();
-        return macaulay_duration / (1 + required_yield / payment_frequency);
+    // `capacity` is rounded up to a power of two.
+    bool create(const char* shm_name, std::uint64_t capacity) {
+        std::uint64_t slots = 1;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        int fd = ::shm_open(shm_name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::ftruncate(fd, bytes_for(slots)) == 0 && map(fd, bytes_for(slots));
+        ::close(fd);
+        if (!ok) {
+            ::shm_unlink(shm_name);
+            return false;
+        }
+        name = shm_name;
+        owner = true;
+        header->capacity = slots;
+        new (&header->head) std::atomic<std::uint64_t>(0);
+        new (&header->tail) std::atomic<std::uint64_t>(0);
+        new (&header->producer_done) std::atomic<std::uint32_t>(0);
+        header->cached_tail = 0;
+        header->cached_head = 0;
+        new (&header->magic) std::atomic<std::uint64_t>(0);
+        header->magic.store(tick_ring_magic, std::memory_order_release);
+        return true;
     }
 
-    double calculate_convexity() const {
-        double convexity = 0.0;
-        double coupon = calculate_coupon();
-        int periods = remaining_years * payment_frequency;
+    bool attach(const char* shm_name) {
+        int fd = ::shm_open(shm_name, O_RDWR, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(TickRingHeader)) &&
+                  map(fd, info.st_size);
+        ::close(fd);
+        if (!ok) {
+            return false;
+        }
+        if (header->magic.load(std::memory_order_acquire) != tick_ring_magic ||
+            bytes_for(header->capacity) != static_cast<std::uint64_t>(info.st_size)) {
+            ::munmap(header, info.st_size);
+            header = nullptr;
+            return false;
+        }
+        return true;
+    }
 
-        for (int t = 1; t <= periods; ++t) {
-            convexity += t * (t + 1) * coupon / pow(1 + required_yield / payment_frequency, t + 2);
+    // Producer side. Returns false when the ring is full.
+    bool try_push(const Tick& tick) {
+        std::uint64_t head = header->head.load(std::memory_order_relaxed);
+        if (head - header->cached_tail == header->capacity) {
+            header->cached_tail = header->tail.load(std::memory_order_acquire);
+            if (head - header->cached_tail == header->capacity) {
+                return false;
+            }
         }
-        convexity += periods * (periods + 1) * face_value / pow(1 + required_yield / payment_frequency, periods + 2);
-        return convexity / market_price;
+        slots()[head & (header->capacity - 1)] = tick;
+        header->head.store(head + 1, std::memory_order_release);
+        return true;
     }
 
-    double calculate_current_yield() const {
-        return calculate_coupon() / market_price;
+    // Producer side: no more ticks will follow.
+    void finish() {
+        header->producer_done.store(1, std::memory_order_release);
     }
 
-    void display_price_sensitivity() const {
-        double yield_change = 0.005; // ±0.5%
-        std::cout << "Price Sensitivity Analysis:\n";
-        for (double i = -2 * yield_change; i <= 2 * yield_change; i += yield_change) {
-            double new_yield = required_yield + i;
-            double new_price = calculate_present_value(new_yield);
-            std::cout << "Yield: " << std::fixed << std::setprecision(4) << new_yield << " | Price: " << new_price << std::endl;
+    // Consumer side. Returns false when the ring is empty.
+    bool try_pop(Tick& tick) {
+        std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        if (tail == header->cached_head) {
+            header->cached_head = header->head.load(std::memory_order_acquire);
+            if (tail == header->cached_head) {
+                return false;
+            }
         }
+        tick = slots()[tail & (header->capacity - 1)];
+        header->tail.store(tail + 1, std::memory_order_release);
+        return true;
     }
 
-    double calculate_break_even_yield(double reference_price) const {
-        double low = 0.0, high = 1.0, mid;
-        while (high - low > 1e-6) {
-            mid = (low + high) / 2.0;
-            double pv = calculate_present_value(mid);
-            if (pv < reference_price) low = mid;
-            else high = mid;
+    bool producer_finished() const {
+        return header->producer_done.load(std::memory_order_acquire) != 0;
+    }
+
+private:
+    TickRingHeader* header = nullptr;
+    std::string name;
+    bool owner = false;
+
+    static std::uint64_t slots_offset() {
+        return (sizeof(TickRingHeader) + 63) / 64 * 64;
+    }
+
+    static std::uint64_t bytes_for(std::uint64_t capacity) {
+        return slots_offset() + capacity * sizeof(Tick);
+    }
+
+    bool map(int fd, std::uint64_t bytes) {
+        void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
         }
-        return mid;
+        header = static_cast<TickRingHeader*>(mapped);
+        return true;
     }
 
-    void display_scenario_analysis() const {
-        double scenarios[] = {-0.02, -0.01, 0.0, 0.01, 0.02}; // ±2%, ±1%
-        std::cout << "Scenario Analysis:\n";
-        for (double delta : scenarios) {
-            double new_yield = required_yield + delta;
-            std::cout << "Yield: " << std::fixed << std::setprecision(4) << new_yield << std::endl;
-            std::cout << "Price: " << calculate_present_value(new_yield) << std::endl;
-            std::cout << "Macaulay Duration: " << calculate_macaulay_duration() << std::endl;
-            std::cout << "Modified Duration: " << calculate_modified_duration() << std::endl;
-            std::cout << "Convexity: " << calculate_convexity() << std::endl;
-            std::cout << std::endl;
+    Tick* slots() const {
+        return reinterpret_cast<Tick*>(reinterpret_cast<char*>(header) + slots_offset());
+    }
+};
+
+// Latest solved yield per bond. The solver thread publishes while any number
+// of threads read; each entry is guarded by a sequence lock, so readers never
+// see a price from one solve paired with the yield from another.
+class YieldBoard {
+public:
+    explicit YieldBoard(std::size_t bonds) : entries(new Entry[bonds]), count(bonds) {}
+
+    std::size_t size() const {
+        return count;
+    }
+
+    void publish(std::size_t bond_id, double price, const YieldSolution& solution) {
+        Entry& entry = entries[bond_id];
+        std::uint64_t sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.price.store(price, std::memory_order_relaxed);
+        entry.yield.store(solution.yield, std::memory_order_relaxed);
+        entry.iterations.store(solution.iterations, std::memory_order_relaxed);
+        entry.converged.store(solution.converged, std::memory_order_relaxed);
+        entry.duration.store(solution.duration, std::memory_order_relaxed);
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Returns false if nothing was published for the bond yet.
+    bool read(std::size_t bond_id, double& price, YieldSolution& solution) const {
+        const Entry& entry = entries[bond_id];
+        while (true) {
+            std::uint64_t before = entry.sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            price = entry.price.load(std::memory_order_relaxed);
+            solution.yield = entry.yield.load(std::memory_order_relaxed);
+            solution.iterations = entry.iterations.load(std::memory_order_relaxed);
+            solution.converged = entry.converged.load(std::memory_order_relaxed);
+            solution.duration = entry.duration.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((before & 1) == 0 && entry.sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
         }
     }
 
-    void display_frequency_analysis() const {
-        int frequencies[] = {1, 2, 4}; // Annual, Semi-Annual, Quarterly
-        std::cout << "Frequency Analysis:\n";
-        for (int freq : frequencies) {
-            Bond temp_bond = *this;
-            temp_bond.payment_frequency = freq;
-            std::cout << "Payment Frequency: " << (freq == 1 ? "Annual" : freq == 2 ? "Semi-Annual" : "Quarterly") << std::endl;
-            std::cout << "Price: " << temp_bond.calculate_present_value(required_yield) << std::endl;
-            std::cout << "Macaulay Duration: " << temp_bond.calculate_macaulay_duration() << std::endl;
-            std::cout << "Modified Duration: " << temp_bond.calculate_modified_duration() << std::endl;
-            std::cout << "Convexity: " << temp_bond.calculate_convexity() << std::endl;
-            std::cout << std::endl;
+private:
+    struct alignas(64) Entry {
+        std::atomic<std::uint64_t> sequence{0}; // Odd while a write is in progress
+        std::atomic<double> price{0.0};
+        std::atomic<double> yield{0.0};
+        std::atomic<int> iterations{0};
+        std::atomic<bool> converged{false};
+        std::atomic<double> duration{0.0};
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t count;
+};
+
+// Keeps only the newest unsolved price per bond. A tick for a bond that is
+// already dirty overwrites its slot, so stale prices are dropped rather than
+// queued and solver work is bounded by the number of distinct bonds ticked.
+class TickCoalescer {
+public:
+    explicit TickCoalescer(std::size_t bonds) : latest(bonds), is_dirty(bonds, 0) {}
+
+    void add(const Tick& tick) {
+        latest[tick.bond_id] = tick.price;
+        if (!is_dirty[tick.bond_id]) {
+            is_dirty[tick.bond_id] = 1;
+            dirty.push_back(tick.bond_id);
         }
     }
 
-    void display_amortization_schedule() const {
-        std::cout << "Amortization Schedule:\n";
-        double coupon = calculate_coupon();
-        int periods = remaining_years * payment_frequency;
-        for (int t = 1; t <= periods; ++t) {
-            double payment_time = static_cast<double>(t) / payment_frequency;
-            double payment = (t == periods) ? (coupon + face_value) : coupon;
-            std::cout << "Period: " << t << " | Payment Time: " << payment_time << " | Payment: " << payment << std::endl;
+    bool empty() const {
+        return dirty.empty();
+    }
+
+    // Calls `solve(bond_id, price)` once per dirty bond and clears the set.
+    // Returns the number of bonds drained.
+    template <typename Solve>
+    std::size_t drain(Solve solve) {
+        for (std::size_t id : dirty) {
+            is_dirty[id] = 0;
+            solve(id, latest[id]);
         }
+        std::size_t drained = dirty.size();
+        dirty.clear();
+        return drained;
     }
 
-    void calculate_required_yield() {
-        if (required_yield == -1.0) {
-            std::cout << "Calculating required yield (YTM) based on the market price..." << std::endl;
-            required_yield = calculate_ytm();
+private:
+    std::vector<double> latest;
+    std::vector<std::uint8_t> is_dirty;
+    std::vector<std::size_t> dirty; // In first-tick order
+};
+
+struct IngestStats {
+    std::uint64_t ticks = 0;  // Popped from the ring
+    std::uint64_t solves = 0; // Yield solves after coalescing
+    std::uint64_t iterations = 0;
+};
+
+// Drains ticks from `ring` through a TickCoalescer, solves each changed bond's
+// yield at its latest price, warm-started from the bond's last published
+// solution, and publishes it on `board`. Runs until `stop` is
+// set, or until the producer has finished and the ring is empty.
+inline IngestStats consume_ticks(SharedTickRing& ring, const BondColumns& book, YieldBoard& board,
+                                 const std::atomic<bool>& stop) {
+    constexpr std::size_t max_batch = 4096; // Ticks taken before solving, bounding publish latency
+    IngestStats stats;
+    TickCoalescer pending(book.size);
+    Tick tick;
+    while (!stop.load(std::memory_order_relaxed)) {
+        bool finished = ring.producer_finished(); // Read first: ticks pushed before finish() must not be lost
+        std::size_t taken = 0;
+        while (taken < max_batch && ring.try_pop(tick)) {
+            ++taken;
+            if (tick.bond_id < book.size) {
+                pending.add(tick);
+            }
+        }
+        stats.ticks += taken;
+        if (pending.empty()) {
+            if (finished && taken == 0) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
         }
+        stats.solves += pending.drain([&](std::size_t id, double price) {
+            Bond bond = book.bond(id);
+            double previous_price;
+            YieldSolution solution;
+            if (board.read(id, previous_price, solution) && solution.converged) {
+                solution = bond.solve_yield_near(price, solution, previous_price);
+            } else {
+                solution = bond.solve_yield(price, bond.approximate_yield(price));
+            }
+            stats.iterations += solution.iterations;
+            board.publish(id, price, solution);
+        });
+    }
+    return stats;
+}
+
+// Stand-in for a live feed: pushes `ticks` random-walk price updates for bonds
+// drawn uniformly from `book`, spinning while the ring is full.
+inline void run_feed_simulator(SharedTickRing& ring, const BondColumns& book, std::uint64_t ticks, std::uint32_t seed = 1) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<std::uint64_t> pick(0, book.size ? book.size - 1 : 0);
+    std::normal_distribution<double> move(0.0, 2e-4);
+    std::vector<double> prices(book.market_price, book.market_price + book.size);
+    for (std::uint64_t i = 0; i < ticks && book.size; ++i) {
+        std::uint64_t id = pick(random);
+        prices[id] *= 1 + move(random);
+        while (!ring.try_push({id, prices[id]})) {
+            std::this_thread::yield();
+        }
+    }
+    ring.finish();
+}
+
+inline std::atomic<bool> ingest_stop_requested{false};
+
+// Solves the ticks arriving on shared-memory ring `shm_name` against a mapped
+// universe. With `sim_ticks` > 0 a feed simulator runs in-process; otherwise an
+// external --feed process attaches to the ring.
+int run_ingest(const char* shm_name, const char* universe_path, std::uint64_t sim_ticks) {
+    struct sigaction stop = {};
+    stop.sa_handler = [](int) { ingest_stop_requested.store(true, std::memory_order_relaxed); };
+    ::sigaction(SIGINT, &stop, nullptr);
+    ::sigaction(SIGTERM, &stop, nullptr);
+
+    MappedBondUniverse universe;
+    if (!universe.open(universe_path)) {
+        std::cerr << "Cannot load " << universe_path << ": " << universe.error() << "\n";
+        return 1;
+    }
+    BondColumns book = universe.columns();
+    SharedTickRing ring;
+    if (!ring.create(shm_name, 1 << 16)) {
+        std::cerr << "Cannot create ring " << shm_name << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    YieldBoard board(book.size);
+    std::thread feed;
+    if (sim_ticks > 0) {
+        feed = std::thread([&] { run_feed_simulator(ring, book, sim_ticks); });
+    } else {
+        std::cerr << "Waiting for ticks on " << shm_name << "\n";
+    }
+    auto start = std::chrono::steady_clock::now();
+    IngestStats stats = consume_ticks(ring, book, board, ingest_stop_requested);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (feed.joinable()) {
+        feed.join();
+    }
+
+    std::size_t updated = 0;
+    double price;
+    YieldSolution solution;
+    for (std::size_t i = 0; i < board.size(); ++i) {
+        updated += board.read(i, price, solution);
     }
+    std::cerr << stats.ticks << " tick(s) in " << seconds << "s (" << stats.ticks / std::max(seconds, 1e-9) << "/s), "
+              << stats.solves << " solve(s) after coalescing, " << static_cast<double>(stats.iterations) / std::max<std::uint64_t>(stats.solves, 1)
+              << " iteration(s) per solve, " << updated << " bond(s) updated\n";
+    return 0;
+}
+
+// Feeds `ticks` simulated price updates into a ring created by --ingest.
+int run_feed(const char* shm_name, const char* universe_path, std::uint64_t ticks) {
+    MappedBondUniverse universe;
+    if (!universe.open(universe_path)) {
+        std::cerr << "Cannot load " << universe_path << ": " << universe.error() << "\n";
+        return 1;
+    }
+    SharedTickRing ring;
+    if (!ring.attach(shm_name)) {
+        std::cerr << "Cannot attach ring " << shm_name << " (is --ingest running?)\n";
+        return 1;
+    }
+    run_feed_simulator(ring, universe.columns(), ticks);
+    return 0;
+}
+
+// Converts a CSV universe (see BondCsvReader) into the binary format.
+int run_pack(const char* csv_path, const char* universe_path) {
+    std::FILE* in = std::strcmp(csv_path, "-") == 0 ? stdin : std::fopen(csv_path, "rb");
+    if (!in) {
+        std::cerr << "Cannot open " << csv_path << "\n";
+        return 1;
+    }
+    BondBook book;
+    BondCsvReader reader(in);
+    Bond bond(0, 0, 0, 0, 1);
+    while (reader.next(bond)) {
+        book.add(bond);
+    }
+    if (in != stdin) {
+        std::fclose(in);
+    }
+    if (!write_bond_universe(universe_path, book.columns())) {
+        std::cerr << "Cannot write " << universe_path << "\n";
+        return 1;
+    }
+    std::cerr << book.size() << " bond(s) packed, " << reader.malformed() << " malformed record(s) skipped\n";
+    return 0;
+}
+
+// Prices a mapped binary universe on all cores, writing the --batch report.
+int run_universe(const char* path, OutputFormat format) {
+    MappedBondUniverse universe;
+    if (!universe.open(path)) {
+        std::cerr << "Cannot load " << path << ": " << universe.error() << "\n";
+        return 1;
+    }
+    BondColumns book = universe.columns();
+    std::vector<double> ytm(book.size), price(book.size);
+    std::vector<BondAnalytics> risk(book.size);
+    ThreadPool pool;
+    PortfolioEngine(pool).run(book, ytm.data(), price.data(), risk.data());
+
+    ReportWriter writer(STDOUT_FILENO, format);
+    writer.header();
+    for (std::size_t i = 0; i < book.size; ++i) {
+        writer.record(ytm[i], risk[i]);
+    }
+    if (!writer.flush()) {
+        std::cerr << "Cannot write report: " << std::strerror(writer.error()) << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+struct BenchStats {
+    double p50; // ns per op
+    double p90;
+    double p99;
 };
 
-int main() {
+// Times `op(i)` over repeated samples. The iteration count per sample is
+// calibrated to roughly 200us so timer overhead stays negligible.
+template <typename Op>
+BenchStats bench_op(Op op, int samples = 41) {
+    using clock = std::chrono::steady_clock;
+    std::size_t iterations = 1;
+    while (true) {
+        clock::time_point start = clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            op(i);
+        }
+        if (clock::now() - start > std::chrono::microseconds(200) || iterations >= (std::size_t(1) << 30)) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    std::vector<double> per_op(samples);
+    for (int s = 0; s < samples; ++s) {
+        clock::time_point start = clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            op(i);
+        }
+        per_op[s] = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+    }
+    std::sort(per_op.begin(), per_op.end());
+    auto rank = [&](double q) { return per_op[static_cast<std::size_t>(q * (samples - 1) + 0.5)]; };
+    return {rank(0.5), rank(0.9), rank(0.99)};
+}
+
+// Sum of the bond's discount factors at `rate`, built with `method`.
+inline double discount_factor_sum(const Bond& bond, double rate, DiscountMethod method) {
+    static thread_local std::vector<double> df;
+    int periods = bond.remaining_years * bond.payment_frequency;
+    df.resize(periods + 1);
+    fill_discount_factors(rate / bond.payment_frequency, periods, df.data(), method);
+    double sum = 0.0;
+    for (int t = 1; t <= periods; ++t) {
+        sum += df[t];
+    }
+    return sum;
+}
+
+// Microbenchmark of the Bond methods over a matrix of maturities, payment
+// frequencies and yields, printed as CSV. `filter` keeps only methods whose
+// name contains it. Inputs are read through a volatile so the compiler cannot
+// hoist the calls out of the timing loop.
+int run_bench(const char* filter) {
+    const int maturities[] = {1, 5, 10, 30, 100};
+    const int frequencies[] = {1, 2, 4, 12};
+    const double yields[] = {0.001, 0.04, 0.12};
+    volatile double sink = 0.0;
+
+    struct Method {
+        const char* name;
+        std::function<double(const Bond&, double)> run;
+    };
+    const Method methods[] = {
+        {"present_value", [](const Bond& b, double y) { return b.calculate_present_value(y); }},
+        {"present_value_vectorized", [](const Bond& b, double y) { return b.calculate_present_value(y, PricingMode::Vectorized); }},
+        {"present_value_reference", [](const Bond& b, double y) { return b.calculate_present_value(y, PricingMode::Reference); }},
+        {"ytm", [](const Bond& b, double) { return b.calculate_ytm(); }},
+        {"macaulay_duration", [](const Bond& b, double) { return b.calculate_macaulay_duration(); }},
+        {"convexity", [](const Bond& b, double) { return b.calculate_convexity(); }},
+        {"analytics", [](const Bond& b, double y) { return b.analytics(y).dv01; }},
+        {"break_even_yield", [](const Bond& b, double) { return b.calculate_break_even_yield(b.market_price); }},
+        {"discount_pow", [](const Bond& b, double y) { return discount_factor_sum(b, y, DiscountMethod::Pow); }},
+        {"discount_recurrence", [](const Bond& b, double y) { return discount_factor_sum(b, y, DiscountMethod::Recurrence); }},
+        {"discount_logexp", [](const Bond& b, double y) { return discount_factor_sum(b, y, DiscountMethod::LogExp); }},
+    };
+
+    std::cout << "# simd=" << simd_isa_name(simd_kernels().isa) << "\n";
+    std::cout << "method,years,frequency,yield,ns_per_op_p50,ns_per_op_p90,ns_per_op_p99,ops_per_s\n";
+    for (const Method& method : methods) {
+        if (filter && !std::strstr(method.name, filter)) {
+            continue;
+        }
+        for (int years : maturities) {
+            for (int freq : frequencies) {
+                for (double yield : yields) {
+                    Bond bond(100.0, 0.05, 0.0, years, freq, yield);
+                    bond.market_price = bond.calculate_present_value(yield);
+                    volatile double input = yield;
+                    BenchStats stats = bench_op([&](std::size_t) { sink = sink + method.run(bond, input); });
+                    std::cout << method.name << ',' << years << ',' << freq << ',' << yield << ','
+                              << std::fixed << std::setprecision(1) << stats.p50 << ',' << stats.p90 << ',' << stats.p99 << ','
+                              << std::setprecision(0) << 1e9 / stats.p50 << '\n'
+                              << std::defaultfloat << std::setprecision(6);
+                }
+            }
+        }
+    }
+    std::cout.flush();
+    return 0;
+}
+
+// Re-runs the accuracy claims of the batch and streaming components against
+// the plain Bond methods on a seeded synthetic book, one CSV line per check
+// (worst error seen, allowed limit). Returns non-zero if any check fails.
+int run_self_check() {
+    const int frequencies[] = {1, 2, 4, 12};
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    BondBook book;
+    for (int i = 0; i < 2000; ++i) {
+        Bond bond(i % 2 ? 1000.0 : 100.0, 0.1 * uniform(random), 0.0, 1 + i % 40, frequencies[i % 4]);
+        double yield = 0.001 + 0.12 * uniform(random);
+        bond.market_price = bond.calculate_present_value(yield);
+        bond.required_yield = i % 5 == 0 ? -1.0 : yield + 0.01 * (uniform(random) - 0.5);
+        book.add(bond);
+    }
+    BondColumns columns = book.columns();
+    auto relative = [](double value, double exact) { return fabs(value - exact) / std::max(fabs(exact), 1e-300); };
+
+    int failures = 0;
+    std::cout << "check,worst,limit,result\n";
+    auto report = [&](const char* name, double worst, double limit) {
+        bool ok = worst <= limit;
+        failures += !ok;
+        std::cout << name << ',' << worst << ',' << limit << ',' << (ok ? "ok" : "FAIL") << '\n';
+    };
+
+    // The yield solvers stop once the price is within `tolerance` (their
+    // default), so two solves of one price may differ in yield by up to
+    // 2 * tolerance / |dP/dy|. Yield comparisons are reported in that unit.
+    const double tolerance = 1e-6;
+    auto yield_gap = [&](const Bond& bond, double yield, double reference) {
+        if (std::isnan(yield) || std::isnan(reference)) {
+            return std::isnan(yield) == std::isnan(reference) ? 0.0 : HUGE_VAL;
+        }
+        return fabs(yield - reference) * bond.analytics(reference).dv01 * 1e4 / (2 * tolerance);
+    };
+
+    // calculate_ytm reproduces the market price.
+    double worst = 0.0;
+    std::vector<double> ytm(columns.size);
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        Bond bond = columns.bond(i);
+        ytm[i] = bond.calculate_ytm();
+        worst = std::max(worst, fabs(bond.calculate_present_value(ytm[i]) - bond.market_price));
+    }
+    report("ytm_reprices", worst, tolerance);
+
+    // The lockstep batch solver agrees with calculate_ytm.
+    std::vector<double> batch_ytm(columns.size);
+    columns.ytm_all(0, columns.size, batch_ytm.data());
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        worst = std::max(worst, yield_gap(columns.bond(i), batch_ytm[i], ytm[i]));
+    }
+    report("ytm_batch_vs_ytm", worst, 1.0);
+
+    // solve_yield_near agrees with a cold solve after a small price move.
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        Bond bond = columns.bond(i);
+        YieldSolution previous = bond.solve_yield(bond.market_price, bond.approximate_yield(bond.market_price));
+        double price = bond.market_price * (1 + 1e-3 * (uniform(random) - 0.5));
+        double cold = bond.solve_yield(price, bond.approximate_yield(price)).yield;
+        worst = std::max(worst, yield_gap(bond, bond.solve_yield_near(price, previous, bond.market_price).yield, cold));
+    }
+    report("warm_start_yield", worst, 1.0);
+
+    // IncrementalPricer's error bound holds along 3bp and 10bp random walks:
+    // worst is the largest |error| / bound over the approximated reprices.
+    for (double step : {3e-4, 1e-3}) {
+        std::normal_distribution<double> move(0.0, step);
+        worst = 0.0;
+        for (std::size_t i = 0; i < columns.size; i += 10) {
+            Bond bond = columns.bond(i);
+            double yield = columns.pricing_yield(i);
+            IncrementalPricer pricer(bond, yield);
+            for (int k = 0; k < 200; ++k) {
+                yield += move(random);
+                RepriceResult result = pricer.reprice(yield);
+                if (!result.exact) {
+                    worst = std::max(worst, fabs(result.price - bond.analytics(yield).price) / result.error_bound);
+                }
+            }
+        }
+        report(step < 5e-4 ? "incremental_bound_3bp" : "incremental_bound_10bp", worst, 1.0);
+    }
+
+    // Batch and cached entry points against Bond::analytics.
+    std::vector<BondAnalytics> risk(columns.size);
+    DiscountCache cache;
+    columns.risk_all(0, columns.size, risk.data(), cache);
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        BondAnalytics exact = columns.bond(i).analytics(columns.pricing_yield(i));
+        worst = std::max({worst, relative(risk[i].price, exact.price), relative(risk[i].modified_duration, exact.modified_duration),
+                          relative(risk[i].convexity, exact.convexity)});
+    }
+    report("discount_cache_analytics", worst, 1e-13);
+
+    columns.risk_all(0, columns.size, risk.data());
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        BondAnalytics exact = columns.bond(i).analytics(columns.pricing_yield(i));
+        worst = std::max({worst, relative(risk[i].price, exact.price), relative(risk[i].convexity, exact.convexity)});
+    }
+    report("risk_all_lanes", worst, 1e-13);
+
+    std::vector<BondAnalytics> sweep(columns.size * 4);
+    columns.frequency_sweep_all(0, columns.size, frequencies, 4, sweep.data());
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        BondAnalytics exact[4];
+        columns.bond(i).frequency_sweep(columns.pricing_yield(i), frequencies, 4, exact);
+        for (int k = 0; k < 4; ++k) {
+            worst = std::max(worst, relative(sweep[i * 4 + k].price, exact[k].price));
+        }
+    }
+    report("frequency_sweep_all", worst, 1e-13);
+
+    ThreadPool pool;
+    const std::vector<double> shocks = {-0.01, 0.0, 0.005, 0.02};
+    ScenarioGrid grid;
+    ScenarioEngine(pool).run(columns, shocks, grid);
+    worst = 0.0;
+    for (std::size_t s = 0; s < shocks.size(); ++s) {
+        for (std::size_t i = 0; i < columns.size; ++i) {
+            BondAnalytics exact = columns.bond(i).analytics(columns.pricing_yield(i) + shocks[s]);
+            std::size_t cell = s * grid.bonds + i;
+            worst = std::max({worst, relative(grid.price[cell], exact.price), relative(grid.modified_duration[cell], exact.modified_duration),
+                              relative(grid.convexity[cell], exact.convexity), relative(grid.dv01[cell], exact.dv01)});
+        }
+    }
+    report("scenario_engine", worst, 1e-13);
+
+    // Discounting the lazily generated schedule reproduces the price.
+    std::vector<double> pv(columns.size, 0.0);
+    columns.for_each_cash_flow(0, columns.size, [&](std::size_t i, const CashFlow& flow) {
+        pv[i] += flow.amount / pow(1 + columns.pricing_yield(i) / columns.payment_frequency[i], flow.period);
+    });
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        worst = std::max(worst, relative(pv[i], columns.bond(i).calculate_present_value(columns.pricing_yield(i))));
+    }
+    report("for_each_cash_flow", worst, 1e-12);
+
+    // PackedBond / BondArena round-trip every field.
+    BondArena arena;
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        Bond bond = columns.bond(i);
+        Bond unpacked = arena.add(bond) ? arena.bond(arena.size() - 1) : Bond(0, 0, 0, 0, 1);
+        bool same = unpacked.face_value == bond.face_value && unpacked.coupon_rate == bond.coupon_rate &&
+                    unpacked.market_price == bond.market_price && unpacked.remaining_years == bond.remaining_years &&
+                    unpacked.payment_frequency == bond.payment_frequency && unpacked.required_yield == bond.required_yield;
+        worst += !same;
+    }
+    report("packed_bond_round_trip", worst, 0.0);
+
+    std::vector<double> book_prices(columns.size), arena_prices(columns.size);
+    book.price_all(book_prices.data());
+    arena.price_all(arena_prices.data());
+    worst = 0.0;
+    for (std::size_t i = 0; i < columns.size; ++i) {
+        worst = std::max(worst, relative(arena_prices[i], book_prices[i]));
+    }
+    report("arena_price_all", worst, 0.0);
+
+    // Discount-factor methods against pow, up to 100 years monthly. Recurrence
+    // shares pow's anchors and adds about one ulp per multiplication between
+    // them. LogExp differs from pow by pow's rounding of 1 + r (t / 2 ulps)
+    // plus exp's amplification of the rounding in t log1p(r) (2 |x| ulps).
+    const int periods = 1200;
+    const double max_rate = 0.5;
+    std::vector<double> reference(periods + 1), factors(periods + 1);
+    double worst_recurrence = 0.0, worst_log_exp = 0.0;
+    for (double rate : {-0.01, 0.0, 1e-9, 0.001, 0.04, 0.12, max_rate}) {
+        fill_discount_factors(rate / 12, periods, reference.data(), DiscountMethod::Pow);
+        fill_discount_factors(rate / 12, periods, factors.data(), DiscountMethod::Recurrence);
+        for (int t = 0; t <= periods; ++t) {
+            worst_recurrence = std::max(worst_recurrence, relative(factors[t], reference[t]));
+        }
+        fill_discount_factors(rate / 12, periods, factors.data(), DiscountMethod::LogExp);
+        for (int t = 0; t <= periods; ++t) {
+            worst_log_exp = std::max(worst_log_exp, relative(factors[t], reference[t]));
+        }
+    }
+    report("discount_recurrence", worst_recurrence, (simd_anchor_periods + 2) * DBL_EPSILON);
+    report("discount_logexp", worst_log_exp, (periods / 2.0 + 2 * periods * log1p(max_rate / 12) + 4) * DBL_EPSILON);
+
+    std::cout.flush();
+    return failures ? 1 : 0;
+}
+
+int run_interactive() {
     double face_value;
     double coupon_rate;
     double market_price;
@@ -190,21 +3291,81 @@ int main() {
         bond.calculate_required_yield();
     }
 
-    // Calculate and display bond metrics
+    // Calculate and display bond metrics; price and risk come from one pass
+    // over the schedule, normalised by the price at the required yield.
+    BondAnalytics risk = bond.analytics(bond.required_yield);
     std::cout << "\nBond Analysis:\n";
-    std::cout << "Present Value (Price): " << bond.calculate_present_value(bond.required_yield) << std::endl;
-    std::cout << "Yield to Maturity (YTM): " << bond.calculate_ytm() << std::endl;
-    std::cout << "Macaulay Duration: " << bond.calculate_macaulay_duration() << std::endl;
-    std::cout << "Modified Duration: " << bond.calculate_modified_duration() << std::endl;
-    std::cout << "Convexity: " << bond.calculate_convexity() << std::endl;
-    std::cout << "Current Yield: " << bond.calculate_current_yield() << std::endl;
+    std::cout << "Present Value (Price): " << risk.price << '\n';
+    std::cout << "Yield to Maturity (YTM): " << bond.calculate_ytm() << '\n';
+    std::cout << "Macaulay Duration: " << risk.macaulay_duration << '\n';
+    std::cout << "Modified Duration: " << risk.modified_duration << '\n';
+    std::cout << "Convexity: " << risk.convexity << '\n';
+    std::cout << "Current Yield: " << bond.calculate_current_yield() << '\n';
 
     bond.display_price_sensitivity();
-    std::cout << "Break-Even Yield: " << bond.calculate_break_even_yield(market_price) << std::endl;
+    std::cout << "Break-Even Yield: " << bond.calculate_break_even_yield(market_price) << '\n';
     bond.display_scenario_analysis();
     bond.display_frequency_analysis();
     bond.display_amortization_schedule();
 
+    std::cout.flush();
     system("pause");
     return 0;
 }
+
+int run_mode(const char* program, const std::vector<const char*>& args, OutputFormat format) {
+    if (!args.empty() && std::strcmp(args[0], "--batch") == 0) {
+        return run_batch(args.size() > 1 ? args[1] : "-", format);
+    }
+    if (args.size() > 2 && std::strcmp(args[0], "--pack") == 0) {
+        return run_pack(args[1], args[2]);
+    }
+    if (args.size() > 1 && std::strcmp(args[0], "--universe") == 0) {
+        return run_universe(args[1], format);
+    }
+    if (args.size() > 1 && std::strcmp(args[0], "--serve") == 0) {
+        return run_server(args[1]);
+    }
+    if (args.size() > 2 && std::strcmp(args[0], "--ingest") == 0) {
+        return run_ingest(args[1], args[2], args.size() > 3 ? std::strtoull(args[3], nullptr, 10) : 0);
+    }
+    if (args.size() > 3 && std::strcmp(args[0], "--feed") == 0) {
+        return run_feed(args[1], args[2], std::strtoull(args[3], nullptr, 10));
+    }
+    if (!args.empty() && std::strcmp(args[0], "--self-check") == 0) {
+        return run_self_check();
+    }
+    if (!args.empty() && std::strcmp(args[0], "--bench") == 0) {
+        return run_bench(args.size() > 1 ? args[1] : nullptr);
+    }
+    if (!args.empty()) {
+        std::cerr << "Usage: " << program << " [--batch [file|-] | --pack in.csv out.bnd | --universe file.bnd | --serve socket"
+                  << " | --ingest shm file.bnd [sim-ticks] | --feed shm file.bnd ticks | --bench [method] | --self-check]"
+                  << " [--format csv|jsonl|binary] [--stats file]\n";
+        return 2;
+    }
+    return run_interactive();
+}
+
+int main(int argc, char** argv) {
+    // --format applies to the --batch and --universe reports.
+    // --stats dumps the instrumentation counters once the mode finishes.
+    OutputFormat format = OutputFormat::Csv;
+    const char* stats_path = nullptr;
+    std::vector<const char*> args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc && parse_output_format(argv[i + 1], format)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    int status = run_mode(argv[0], args, format);
+    if (stats_path && !dump_instrumentation(stats_path)) {
+        std::cerr << "Cannot write " << stats_path << " (instrumentation needs -DBOND_INSTRUMENT)\n";
+    }
+    return status;
+}